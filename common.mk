@@ -3,19 +3,27 @@ DEVICE=VexCortex
 
 MFLAGS=-mthumb -mcpu=cortex-m3 -mlittle-endian
 CPPFLAGS=-Os
-GCCFLAGS=-ffunction-sections -fsigned-char -fomit-frame-pointer -fsingle-precision-constant -fdiagnostics-color
+GCCFLAGS=-ffunction-sections -fdata-sections -fsigned-char -fomit-frame-pointer -fsingle-precision-constant -fdiagnostics-color
 
 WARNFLAGS+=
 
 SPACE :=
 SPACE +=
 COMMA := ,
-LNK_FLAGS = --gc-sections
+# malloc() and free() are wrapped to track heap use (see memory.h)
+LNK_FLAGS = --gc-sections --wrap=malloc --wrap=free -Map=$(OUTMAP)
+
+# Link time optimisation. The linker plugin doesn't count the references --wrap makes, so the
+# wrappers are marked as used from outside or LTO would drop them.
+ifeq ($(LTO),1)
+GCCFLAGS+=-flto
+LTO_LDFLAGS=$(CPPFLAGS) $(GCCFLAGS) -Wl,-u,__wrap_malloc -Wl,-u,__wrap_free
+endif
 
 ASMFLAGS=$(MFLAGS) $(WARNFLAGS)
 CFLAGS=$(MFLAGS) $(CPPFLAGS) $(WARNFLAGS) $(GCCFLAGS) -std=gnu99
 CXXFLAGS=$(MFLAGS) $(CPPFLAGS) $(WARNFLAGS) -fno-exceptions -fno-rtti -felide-constructors $(GCCFLAGS) --std=gnu++11
-LDFLAGS=$(MFLAGS) $(WARNFLAGS) -nostartfiles -Wl,-static -Bfirmware -Wl,-u,VectorTable -Wl,-T -Xlinker firmware/cortex.ld $(subst ?%,$(SPACE),$(addprefix -Wl$(COMMA), $(LNK_FLAGS)))
+LDFLAGS=$(MFLAGS) $(WARNFLAGS) $(LTO_LDFLAGS) -nostartfiles -Wl,-static -Bfirmware -Wl,-u,VectorTable -Wl,-T -Xlinker firmware/cortex.ld $(subst ?%,$(SPACE),$(addprefix -Wl$(COMMA), $(LNK_FLAGS)))
 SIZEFLAGS=-d --common
 NUMFMTFLAGS=--to=iec --format %.2f --suffix=B
 
@@ -29,6 +37,7 @@ LD:=$(ARCHTUPLE)gcc
 OBJCOPY:=$(ARCHTUPLE)objcopy
 SIZETOOL:=$(ARCHTUPLE)size
 READELF:=$(ARCHTUPLE)readelf
+NM:=$(ARCHTUPLE)nm
 STRIP:=$(ARCHTUPLE)strip
 
 ifneq (, $(shell command -v gnumfmt 2> /dev/null))
@@ -47,6 +56,19 @@ else
 SIZES_SED:=
 endif
 
+# libgcc soft-float routines. The Cortex has no FPU, so any of these showing up in the image
+# means float or double math has crept into the code.
+SOFTFLOAT_SYMBOLS:=__aeabi_[df][a-z0-9]+|__aeabi_u?[il]2[df]|__(add|sub|mul|div|neg)[sd]f[23]|__fix(uns)?[sd]f[sd]i|__float(un)?[sd]i[sd]f|__extendsfdf2|__truncdfsf2
+
+# Fails if the given ELF links in any of the soft-float routines
+define check_softfloat
+@if $(NM) $1 | grep -qE ' [Tt] ($(SOFTFLOAT_SYMBOLS))$$'; then \
+	$(ECHO) "$(ERROR_STRING) soft-float routines linked into $1:"; \
+	$(NM) $1 | grep -E ' [Tt] ($(SOFTFLOAT_SYMBOLS))$$'; \
+	false; \
+fi
+endef
+
 rwildcard=$(foreach d,$(filter-out $3,$(wildcard $1*)),$(call rwildcard,$d/,$2,$3)$(filter $(subst *,%,$2),$d))
 
 # Colors
@@ -0,0 +1,125 @@
+/** @file arm.h
+ * @brief Position controller for the intake arm
+ *
+ * The arm is held at a target position by a PID loop running in its own high priority task, so
+ * it runs faster than (and independently of) the operator control loop. Other tasks only set
+ * the target with armSetTarget().
+ */
+
+#ifndef ARM_H_
+#define ARM_H_
+
+#include <API.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bounds for the arm (with calibration, the lowered state is 0)
+#define ARM_LOWER_BOUND 0
+#define ARM_UPPER_BOUND 4000
+
+// How far the driver moves the arm target every 20ms while an arm button is held, to a max of
+// 4096
+#define IDEAL_ARM_INCREMENT 30
+
+// Period of the arm control loop in ms (200Hz)
+#define ARM_PERIOD 5
+
+// Speed of the arm at full voltage with no load, in potentiometer units per second. Only
+// used by the motor thermal model, so it doesn't need to be exact.
+#define ARM_FREE_SPEED 5000
+
+// Priority of the arm task, above the operator control task and the same as the drive's
+#define ARM_TASK_PRIORITY (TASK_PRIORITY_DEFAULT + 1)
+// Stack size of the arm task in words, see stackPrint() for how much of it gets used
+#define ARM_STACK_SIZE TASK_DEFAULT_STACK_SIZE
+
+// Default gains (see config.h for the tuned ones)
+// Volts per unit of position error, the gain of the old P-only hold
+#define ARM_KP Q16(0.1)
+// Volts per unit of accumulated error (accumulated once every ARM_PERIOD)
+#define ARM_KI Q16(0.001)
+// Volts per unit of position change per ARM_PERIOD
+#define ARM_KD Q16(0.25)
+
+// The most the integral term may contribute to the output, in volts
+#define ARM_INTEGRAL_LIMIT 40
+// The most the output may change by in one ARM_PERIOD
+#define ARM_SLEW 12
+
+// Number of points in the gravity feedforward table, evenly spaced from ARM_LOWER_BOUND to
+// ARM_UPPER_BOUND
+#define ARM_FEEDFORWARD_POINTS 32
+
+// While learning the feedforward table, the arm has to stay within this many units of each
+// point and move slower than ARM_LEARN_SPEED units per second for ARM_LEARN_SETTLE_TIME ms
+// before the output is recorded. Points that don't settle in ARM_LEARN_POINT_TIMEOUT ms keep
+// their old value.
+#define ARM_LEARN_TOLERANCE 15
+#define ARM_LEARN_SPEED 20
+#define ARM_LEARN_SETTLE_TIME 300
+#define ARM_LEARN_POINT_TIMEOUT 3000
+
+/**
+ * Starts the arm control task. Call this once from initialize().
+ */
+void armInit();
+
+/**
+ * Sets the position the arm should move to and hold. This is safe to call from any task.
+ *
+ * @param target The calibrated potentiometer value to hold, clamped to the arm bounds
+ */
+void armSetTarget(int target);
+
+/**
+ * @return The position the arm is currently trying to hold
+ */
+int armGetTarget();
+
+/**
+ * @return The filtered, calibrated potentiometer value the arm task last used
+ */
+int armGetPosition();
+
+/**
+ * @return The voltage most recently sent to the arm motors
+ */
+int armGetOutput();
+
+/**
+ * Starts learning the gravity feedforward table. The arm moves through every table point going
+ * up and then going down, holding each one with the PID, and each entry becomes the average of
+ * the voltages that held it in both directions (which cancels out static friction). The table
+ * is part of the tuning config, so configSave() keeps it over restarts. Targets
+ * from armSetTarget() are ignored until the sweep finishes or is cancelled. The robot must be
+ * enabled and the arm free to move through its whole range.
+ */
+void armLearnStart();
+
+/**
+ * Stops learning the feedforward table. Points already finished on the way back down keep
+ * their new values, the rest keep their old ones.
+ */
+void armLearnCancel();
+
+/**
+ * @return true while the feedforward table is being learned
+ */
+bool armLearning();
+
+/**
+ * Prints the feedforward table as a C initializer that can be pasted into the defaults in
+ * config.c
+ *
+ * @param stream The stream to print to, such as stdout
+ */
+void armPrintFeedforward(PROS_FILE *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,57 @@
+/** @file bench.h
+ * @brief Micro-benchmarks of the calls in the control loop
+ *
+ * "make bench" builds a separate image (bin/bench/bench.bin) with BENCH set, where
+ * operatorControl() runs benchRun() instead of the robot. Each benchmark calls one primitive
+ * BENCH_ITERATIONS times (fewer for the slow ones) and the time of an empty call is taken off,
+ * so the table printed over serial is the cost of the primitive itself. Times come from the
+ * DWT cycle counter through timing.h.
+ *
+ * initialize() only calls benchInit(), so none of the robot's tasks exist and nothing else uses
+ * the LCD. The benchmarks run at the highest priority, so only the kernel's own interrupts get
+ * the processor while they are being timed. Nothing moves: the motor benchmark writes 0 to the
+ * LED strip's port.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Set by the bench target in the Makefile
+#ifndef BENCH
+#define BENCH 0
+#endif
+
+// Calls per benchmark
+#define BENCH_ITERATIONS 1000
+
+// UART the fwrite() benchmark writes to, and how many bytes per call
+#define BENCH_UART uart2
+#define BENCH_UART_BAUD 115200
+#define BENCH_WRITE_SIZE 16
+
+// Motor port for the motorSet() benchmark. Port 1 only powers the LED strip, so writing 0 to
+// it is harmless.
+#define BENCH_MOTOR_PORT 1
+
+/**
+ * Sets up what the benchmarked calls need (the cycle counter, the arm potentiometer's
+ * calibration and the LCD). Called from initialize() in place of the robot's subsystems.
+ */
+void benchInit();
+
+/**
+ * Runs every benchmark once, prints the table to stdout and then waits forever
+ */
+void benchRun() __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
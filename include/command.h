@@ -0,0 +1,214 @@
+/** @file command.h
+ * @brief Cooperative commands for autonomous and macros
+ *
+ * A command is an action spread over many ticks, such as raising the tray or driving a path.
+ * Every tick, commandRun() calls each running command's execute function once, so any number of
+ * commands can run at the same time from one task without blocking it.
+ *
+ * Commands are statically allocated Command structs, usually declared with the COMMAND_*
+ * macros below. Groups run their children one after another (COMMAND_SEQUENCE), all at once
+ * until every child is done (COMMAND_PARALLEL) or all at once until any child is done
+ * (COMMAND_RACE). Groups can contain other groups, and a command can appear more than once in
+ * a sequence, but never twice in commands that run at the same time.
+ *
+ * Each command lists the motor ports it drives in its requirements (groups require everything
+ * their children do). Starting a command interrupts any running command that needs the same
+ * ports, so two commands never drive the same motor at once. Commands request their motors at
+ * MOTOR_PRIORITY_MACRO, and the task running them flushes the ports as usual.
+ *
+ * Everything here must be used from a single task.
+ */
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Most top level commands that can run at the same time
+#define COMMAND_MAX_RUNNING 8
+
+// Most children in a group, checked when a group is declared. Parallel groups and races keep
+// one bit per child, so at most 32.
+#define COMMAND_MAX_CHILDREN 16
+
+#if COMMAND_MAX_CHILDREN <= 16
+typedef uint16_t CommandChildMask;
+#elif COMMAND_MAX_CHILDREN <= 32
+typedef uint32_t CommandChildMask;
+#else
+#error "COMMAND_MAX_CHILDREN can be at most 32"
+#endif
+
+typedef struct Command Command;
+
+/**
+ * A command and its state. Only the fields up to the state should be set when declaring one.
+ */
+struct Command
+{
+    const char *name;
+    // Called when the command starts. May be NULL.
+    void (*init)(Command *command);
+    // Called every tick while the command runs. May be NULL.
+    void (*execute)(Command *command);
+    // Called after every execute to see if the command is done. NULL runs until the timeout.
+    bool (*isFinished)(Command *command);
+    // Called when the command stops, with interrupted set if it was cancelled or timed out
+    // before it finished. May be NULL.
+    void (*end)(Command *command, bool interrupted);
+    // Mask of the motor ports driven by the command, see MOTOR_PORT_BIT()
+    uint16_t requirements;
+    // How long the command may run for in ms, 0 for no limit
+    unsigned long timeout;
+    // Children of a group
+    Command *const *children;
+    uint8_t childCount;
+    // Parameters for the command's functions
+    const void *data;
+    int args[2];
+
+    // State, managed by command.c except for locals, which the command's functions can use
+    // however they like
+    int locals[2];
+    unsigned long startTime;
+    CommandChildMask finishedChildren;
+    uint8_t currentChild;
+    bool running;
+};
+
+/**
+ * Starts a command, first interrupting every running command that shares a motor port with it.
+ * Does nothing if the command is already running.
+ *
+ * @param command The command to start
+ * @return true if the command is running, false if too many commands were already running
+ */
+bool commandStart(Command *command);
+
+/**
+ * Stops a command started with commandStart(), if it is running
+ *
+ * @param command The command to stop
+ */
+void commandCancel(Command *command);
+
+/**
+ * Stops every running command and forgets old switch events. Call this when the task running
+ * commands starts, since the kernel may have stopped the last one in the middle of a command.
+ */
+void commandCancelAll();
+
+/**
+ * Takes the switch events since the last tick, then runs every running command for one tick,
+ * ending the ones that finished or timed out
+ */
+void commandRun();
+
+/**
+ * For commands that finish on a limit switch
+ *
+ * @param pin The digital pin of a switch (see switches.h)
+ * @return true if the switch was pressed since the last tick
+ */
+bool commandSwitchPressed(unsigned char pin);
+
+/**
+ * @param ports A mask of ports built from MOTOR_PORT_BIT()
+ * @return true if a running command requires any of the ports
+ */
+bool commandUsing(uint16_t ports);
+
+/**
+ * @param command The command
+ * @return true if the command, or the group it is in, is running
+ */
+bool commandIsRunning(const Command *command);
+
+/**
+ * @param command The command
+ * @return The motor ports required by the command and, for groups, all of its children
+ */
+uint16_t commandRequirements(const Command *command);
+
+// Group functions, used by the group macros below
+void commandSequenceInit(Command *command);
+void commandSequenceExecute(Command *command);
+bool commandSequenceIsFinished(Command *command);
+void commandParallelInit(Command *command);
+void commandParallelExecute(Command *command);
+bool commandParallelIsFinished(Command *command);
+bool commandRaceIsFinished(Command *command);
+void commandGroupEnd(Command *command, bool interrupted);
+
+// Requests args[0] on every required port, see COMMAND_POWER
+void commandPowerExecute(Command *command);
+
+// The number of children in a group's array. Fails to compile, on the negative array size, if
+// there are more than COMMAND_MAX_CHILDREN.
+#define COMMAND_CHILD_COUNT(childArray) \
+    (sizeof(childArray) / sizeof((childArray)[0]) + 0 * sizeof(char[ \
+    sizeof(childArray) / sizeof((childArray)[0]) <= COMMAND_MAX_CHILDREN ? 1 : -1]))
+
+#define COMMAND_CHILDREN(childArray) \
+    .children = (childArray), .childCount = COMMAND_CHILD_COUNT(childArray)
+
+/**
+ * Declares a group that runs its children one after another
+ *
+ * @param commandName The name of the group
+ * @param childArray A Command *const array of the children
+ */
+#define COMMAND_SEQUENCE(commandName, childArray) \
+    {.name = (commandName), .init = commandSequenceInit, .execute = commandSequenceExecute, \
+    .isFinished = commandSequenceIsFinished, .end = commandGroupEnd, COMMAND_CHILDREN(childArray)}
+
+/**
+ * Declares a group that runs its children at the same time until all of them are done
+ *
+ * @param commandName The name of the group
+ * @param childArray A Command *const array of the children
+ */
+#define COMMAND_PARALLEL(commandName, childArray) \
+    {.name = (commandName), .init = commandParallelInit, .execute = commandParallelExecute, \
+    .isFinished = commandParallelIsFinished, .end = commandGroupEnd, COMMAND_CHILDREN(childArray)}
+
+/**
+ * Declares a group that runs its children at the same time until any of them is done, then
+ * interrupts the rest
+ *
+ * @param commandName The name of the group
+ * @param childArray A Command *const array of the children
+ */
+#define COMMAND_RACE(commandName, childArray) \
+    {.name = (commandName), .init = commandParallelInit, .execute = commandParallelExecute, \
+    .isFinished = commandRaceIsFinished, .end = commandGroupEnd, COMMAND_CHILDREN(childArray)}
+
+/**
+ * Declares a command that holds its motor ports at a fixed power
+ *
+ * @param commandName The name of the command
+ * @param ports Mask of the motor ports to drive
+ * @param power The logical power for the ports. -127 to 127
+ * @param time How long to hold the power in ms, 0 to hold it until interrupted
+ */
+#define COMMAND_POWER(commandName, ports, power, time) \
+    {.name = (commandName), .execute = commandPowerExecute, .requirements = (ports), \
+    .timeout = (time), .args = {(power)}}
+
+/**
+ * Declares a command that does nothing for a while
+ *
+ * @param commandName The name of the command
+ * @param time How long to wait in ms
+ */
+#define COMMAND_WAIT(commandName, time) {.name = (commandName), .timeout = (time)}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
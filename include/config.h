@@ -0,0 +1,174 @@
+/** @file config.h
+ * @brief Tuning values stored in flash
+ *
+ * The tuning values live in one record that is loaded into RAM once by configLoad() in
+ * initialize(). Code reads the fields of config directly, so using a tuned value costs the
+ * same as using a #define. The #defines that used to hold the values are now their defaults.
+ *
+ * The record is versioned and CRC checked. Saves alternate between two files, each stamped
+ * with a sequence number, so the last good record survives a save that gets cut off by a power
+ * loss and each save only writes the flash of one small file. Saves are skipped when nothing
+ * changed, since every save uses up flash until the next power cycle.
+ *
+ * Scalar fields can be listed and edited by name through configFields, which the serial
+ * console (configConsoleInit()) and the LCD menu use.
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <API.h>
+#include "arm.h"
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Marks a config file, "TUNE"
+#define CONFIG_MAGIC 0x454E5554
+// Bump this whenever the layout of Config changes, so old records get replaced by defaults
+#define CONFIG_VERSION 3
+
+// The two files that saves alternate between (at most 8 characters)
+#define CONFIG_FILE_0 "config0"
+#define CONFIG_FILE_1 "config1"
+
+// Priority of the serial console task
+#define CONFIG_CONSOLE_PRIORITY (TASK_PRIORITY_LOWEST + 1)
+#define CONFIG_CONSOLE_STACK_SIZE TASK_DEFAULT_STACK_SIZE
+
+/**
+ * The tuning record, stored as is. Every scalar field is 32 bits so it can be changed from
+ * another task while the control tasks read it.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    // Incremented by every save, the file with the highest valid sequence is loaded
+    uint32_t sequence;
+
+    // Arm PID gains, see arm.h
+    q16_t armKp;
+    q16_t armKi;
+    q16_t armKd;
+    // Highest arm target
+    int32_t armUpperBound;
+    // How far the arm target moves every control tick while an arm button is held
+    int32_t armIncrement;
+    // Tray position that stands a stack upright, and the tray's P gain, see tray.h
+    int32_t trayStackPosition;
+    q16_t trayKp;
+    // Voltage for backing up the drive motors
+    int32_t backupSpeed;
+    // Nonzero to run the drive in velocity mode, and its gains, see drive.h
+    int32_t driveVelocity;
+    q16_t driveKv;
+    q16_t driveKp;
+    q16_t driveKi;
+    // Index into autonPaths of the autonomous path to run, or autonPathCount to replay the
+    // recorded driver run (see replay.h)
+    int32_t autonSelection;
+    // Learned gravity feedforward table, see armLearnStart()
+    int8_t armFeedforward[ARM_FEEDFORWARD_POINTS];
+
+    // CRC-16/CCITT of every byte before this one
+    uint16_t crc;
+} Config;
+
+/**
+ * How a scalar field is stored
+ */
+typedef enum
+{
+    CONFIG_INT,
+    CONFIG_Q16
+} ConfigType;
+
+/**
+ * Description of a scalar field in Config
+ */
+typedef struct
+{
+    const char *name;
+    ConfigType type;
+    // offsetof() the field in Config
+    uint16_t offset;
+    // Range of the field and how much one LCD button press changes it, in the stored units
+    int32_t min;
+    int32_t max;
+    int32_t step;
+} ConfigField;
+
+// The loaded tuning values
+extern Config config;
+
+// The editable fields
+extern const ConfigField configFields[];
+extern const unsigned int configFieldCount;
+
+/**
+ * Loads the newest valid record from flash, or the defaults if there isn't one. Call this at
+ * the start of initialize(), before anything reads config.
+ */
+void configLoad();
+
+/**
+ * Writes config to flash if it changed since it was loaded or last saved. Refuses while the
+ * robot is enabled, since the kernel holds off most tasks while the flash is written. Like
+ * configSet() and configReset(), this can be called from any task.
+ *
+ * @return true if the record in flash matches config afterwards
+ */
+bool configSave();
+
+/**
+ * Puts every field back to its default. Doesn't save.
+ */
+void configReset();
+
+/**
+ * Looks up a field by name
+ *
+ * @param name The name, which may be followed by a space and more text
+ * @return The field's index into configFields, or configFieldCount if there is no such field
+ */
+unsigned int configFind(const char *name);
+
+/**
+ * @param field Index into configFields
+ * @return The field's value in its stored units
+ */
+int32_t configGet(unsigned int field);
+
+/**
+ * Sets a field, clamped to its range. Doesn't save.
+ *
+ * @param field Index into configFields
+ * @param value The new value in its stored units
+ */
+void configSet(unsigned int field, int32_t value);
+
+/**
+ * Formats a field's value for display, Q16 fields with 3 decimal places
+ *
+ * @param field Index into configFields
+ * @param buffer Where to write the text
+ * @param size The size of the buffer
+ */
+void configFormat(unsigned int field, char *buffer, size_t size);
+
+/**
+ * Starts a task that takes commands from the PC debug terminal (stdin): "get" lists every
+ * field, "set <name> <value>" changes one, "save" writes them to flash and "reset" puts them
+ * back to defaults. Call this once from initialize().
+ */
+void configConsoleInit();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
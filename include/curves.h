@@ -0,0 +1,39 @@
+/** @file curves.h
+ * @brief Joystick response curves
+ *
+ * The curves are 256 entry lookup tables in flash, generated at build time by
+ * tools/gencurves.py with the scale, expo and deadband for each axis baked in, so shaping a
+ * joystick input is one table index with no branches or divides.
+ */
+
+#ifndef CURVES_H_
+#define CURVES_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward/backward drive power from joystick axis 3
+extern const int8_t forwardCurve[256];
+// Turning drive power from joystick axis 1
+extern const int8_t turnCurve[256];
+
+/**
+ * Shapes a joystick value with a response curve
+ *
+ * @param curve The curve table
+ * @param value The raw joystick value. -127 to 127
+ * @return The shaped value. -127 to 127
+ */
+static inline int curveApply(const int8_t *curve, int value)
+{
+    return curve[(uint8_t)value];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+/** @file drive.h
+ * @brief Drive base output and velocity control
+ *
+ * The drive motors belong to a task running every DRIVE_PERIOD. Other tasks request a speed for
+ * each side with driveRequest() and hand the winning request over with driveFlush() at the end
+ * of their tick, the same way as motor requests (see motor.h).
+ *
+ * With config.driveVelocity off, a request is the motor voltage, as before. With it on, a
+ * request is a fraction of DRIVE_MAX_SPEED and each side runs a fixed point PI loop with a
+ * velocity feedforward on the wheel speeds from odometry, so a full stick gives the same speed
+ * on a fresh battery and a flat one.
+ */
+
+#ifndef DRIVE_H_
+#define DRIVE_H_
+
+#include <API.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Period of the drive task in ms
+#define DRIVE_PERIOD 10
+
+// The drive task reads the wheel speeds, so it has to be below the odometry task (checked in
+// drive.c). It is above the operator control and autonomous tasks so their work can't delay
+// it.
+#define DRIVE_TASK_PRIORITY (TASK_PRIORITY_DEFAULT + 1)
+#define DRIVE_STACK_SIZE TASK_DEFAULT_STACK_SIZE
+
+// Free speed of a 100rpm motor on a 4" wheel, in inches per second
+#define DRIVE_FREE_SPEED 21.0
+
+// Wheel speed of a full request in velocity mode, in inches per second. A bit under the free
+// speed, so a sagging battery can still reach it.
+#define DRIVE_MAX_SPEED 18.0
+
+// Default gains (see config.h for the tuned ones)
+// Volts per inch per second of target speed, the voltage it takes to hold a speed
+#define DRIVE_KV Q16(127.0 / DRIVE_FREE_SPEED)
+// Volts per inch per second of speed error
+#define DRIVE_KP Q16(4.0)
+// Volts per inch per second of speed error, accumulated once every DRIVE_PERIOD
+#define DRIVE_KI Q16(0.1)
+
+// The most the integral term may contribute to the output, in volts
+#define DRIVE_INTEGRAL_LIMIT 40
+
+/**
+ * Starts the drive task. Call this once from initialize(), after odometryInit().
+ */
+void driveInit();
+
+/**
+ * Requests a speed for each side of the drive for this tick. The request only replaces an
+ * earlier one from the same tick if its priority is at least as high. Only one task may
+ * request at a time.
+ *
+ * @param left The left side, -127 to 127. Voltage, or a fraction of DRIVE_MAX_SPEED in
+ *        velocity mode
+ * @param right The right side, in the same units
+ * @param priority The priority of the request, one of the MOTOR_PRIORITY_* values
+ */
+void driveRequest(int left, int right, unsigned int priority);
+
+/**
+ * Hands the winning request of this tick to the drive task and clears the request. The drive
+ * keeps the last flushed request if nothing was requested.
+ */
+void driveFlush();
+
+/**
+ * Stops the drive and drops any request of this tick. Call this from the requesting task when
+ * it starts, so the drive doesn't resume a request left over from before a disable.
+ */
+void driveReset();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,351 @@
+/** @file fixed.h
+ * @brief Header-only fixed point math
+ *
+ * The Cortex's STM32F103 has no FPU, so every float or double operation becomes a call into the
+ * libgcc soft-float routines. These types do the same job with plain integer instructions.
+ *
+ * q16_t is Q16.16 (16 integer bits, 16 fractional bits) for general purpose math such as gains
+ * and filters. q8_t is Q8.8 for small scale factors where a 16 bit value is enough.
+ *
+ * Q16() and Q8() convert a constant such as a gain at compile time. Only use them on constant
+ * expressions, otherwise they will pull the soft-float routines back in.
+ *
+ * Angles for q16Sin() and q16Cos() are binary angles: a uint16_t where 65536 is one full turn,
+ * so they wrap around for free.
+ */
+
+#ifndef FIXED_H_
+#define FIXED_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int32_t q16_t;
+typedef int16_t q8_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE ((q16_t)1 << Q16_SHIFT)
+#define Q16_MAX ((q16_t)INT32_MAX)
+#define Q16_MIN ((q16_t)INT32_MIN)
+
+#define Q8_SHIFT 8
+#define Q8_ONE ((q8_t)(1 << Q8_SHIFT))
+#define Q8_MAX ((q8_t)INT16_MAX)
+#define Q8_MIN ((q8_t)INT16_MIN)
+
+// Compile time conversion of a constant, rounded to the nearest representable value
+#define Q16(x) ((q16_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define Q8(x) ((q8_t)((x) * 256.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/**
+ * Clamps an integer to a range
+ *
+ * @param value The value to clamp
+ * @param min The lowest allowed value
+ * @param max The highest allowed value
+ * @return The clamped value
+ */
+static inline int clampInt(int value, int min, int max)
+{
+    if(value < min)
+    {
+        return min;
+    }
+    if(value > max)
+    {
+        return max;
+    }
+    return value;
+}
+
+/**
+ * Saturates a 64 bit intermediate to the Q16.16 range
+ */
+static inline q16_t q16Saturate(int64_t value)
+{
+    if(value > Q16_MAX)
+    {
+        return Q16_MAX;
+    }
+    if(value < Q16_MIN)
+    {
+        return Q16_MIN;
+    }
+    return (q16_t)value;
+}
+
+/**
+ * @param x An integer
+ * @return x as Q16.16. Values outside of +/-32767 overflow.
+ */
+static inline q16_t q16FromInt(int x)
+{
+    return (q16_t)(x * Q16_ONE);
+}
+
+/**
+ * @param x A Q16.16 value
+ * @return x rounded to the nearest integer
+ */
+static inline int q16ToInt(q16_t x)
+{
+    return (int)(((int64_t)x + (Q16_ONE >> 1)) >> Q16_SHIFT);
+}
+
+/**
+ * @return a * b, saturated
+ */
+static inline q16_t q16Mul(q16_t a, q16_t b)
+{
+    return q16Saturate(((int64_t)a * b + (Q16_ONE >> 1)) >> Q16_SHIFT);
+}
+
+/**
+ * Scales an integer by a fixed point factor, such as applying a gain to a sensor reading
+ *
+ * @return x * gain rounded to the nearest integer
+ */
+static inline int q16MulInt(q16_t gain, int x)
+{
+    return (int)(((int64_t)gain * x + (Q16_ONE >> 1)) >> Q16_SHIFT);
+}
+
+/**
+ * @return a / b, saturated. Dividing by zero saturates in the direction of a.
+ */
+static inline q16_t q16Div(q16_t a, q16_t b)
+{
+    if(b == 0)
+    {
+        return a >= 0 ? Q16_MAX : Q16_MIN;
+    }
+    return q16Saturate(((int64_t)a << Q16_SHIFT) / b);
+}
+
+/**
+ * @return a + b, saturated instead of wrapping around
+ */
+static inline q16_t q16AddSat(q16_t a, q16_t b)
+{
+    return q16Saturate((int64_t)a + b);
+}
+
+/**
+ * @return a - b, saturated instead of wrapping around
+ */
+static inline q16_t q16SubSat(q16_t a, q16_t b)
+{
+    return q16Saturate((int64_t)a - b);
+}
+
+/**
+ * Linearly interpolates between two values
+ *
+ * @param a The value at t = 0
+ * @param b The value at t = Q16_ONE
+ * @param t The position between a and b
+ * @return The interpolated value
+ */
+static inline q16_t q16Lerp(q16_t a, q16_t b, q16_t t)
+{
+    return q16Saturate(a + ((((int64_t)b - a) * t) >> Q16_SHIFT));
+}
+
+/**
+ * @return value clamped between min and max
+ */
+static inline q16_t q16Clamp(q16_t value, q16_t min, q16_t max)
+{
+    if(value < min)
+    {
+        return min;
+    }
+    if(value > max)
+    {
+        return max;
+    }
+    return value;
+}
+
+/**
+ * Saturates a 32 bit intermediate to the Q8.8 range
+ */
+static inline q8_t q8Saturate(int32_t value)
+{
+    if(value > Q8_MAX)
+    {
+        return Q8_MAX;
+    }
+    if(value < Q8_MIN)
+    {
+        return Q8_MIN;
+    }
+    return (q8_t)value;
+}
+
+/**
+ * @param x An integer
+ * @return x as Q8.8. Values outside of +/-127 overflow.
+ */
+static inline q8_t q8FromInt(int x)
+{
+    return (q8_t)(x * Q8_ONE);
+}
+
+/**
+ * @param x A Q8.8 value
+ * @return x rounded to the nearest integer
+ */
+static inline int q8ToInt(q8_t x)
+{
+    return (x + (Q8_ONE >> 1)) >> Q8_SHIFT;
+}
+
+/**
+ * @return a * b, saturated
+ */
+static inline q8_t q8Mul(q8_t a, q8_t b)
+{
+    return q8Saturate(((int32_t)a * b + (Q8_ONE >> 1)) >> Q8_SHIFT);
+}
+
+/**
+ * Scales an integer by a fixed point factor, such as a joystick value by a sensitivity
+ *
+ * @return x * scale rounded to the nearest integer
+ */
+static inline int q8MulInt(q8_t scale, int x)
+{
+    return ((int32_t)scale * x + (Q8_ONE >> 1)) >> Q8_SHIFT;
+}
+
+/**
+ * @return a / b, saturated. Dividing by zero saturates in the direction of a.
+ */
+static inline q8_t q8Div(q8_t a, q8_t b)
+{
+    if(b == 0)
+    {
+        return a >= 0 ? Q8_MAX : Q8_MIN;
+    }
+    return q8Saturate(((int32_t)a << Q8_SHIFT) / b);
+}
+
+/**
+ * @return a + b, saturated instead of wrapping around
+ */
+static inline q8_t q8AddSat(q8_t a, q8_t b)
+{
+    return q8Saturate((int32_t)a + b);
+}
+
+/**
+ * @return a - b, saturated instead of wrapping around
+ */
+static inline q8_t q8SubSat(q8_t a, q8_t b)
+{
+    return q8Saturate((int32_t)a - b);
+}
+
+/**
+ * Linearly interpolates between two values
+ *
+ * @param a The value at t = 0
+ * @param b The value at t = Q8_ONE
+ * @param t The position between a and b
+ * @return The interpolated value
+ */
+static inline q8_t q8Lerp(q8_t a, q8_t b, q8_t t)
+{
+    return q8Saturate(a + ((((int32_t)b - a) * t) >> Q8_SHIFT));
+}
+
+/**
+ * @return value clamped between min and max
+ */
+static inline q8_t q8Clamp(q8_t value, q8_t min, q8_t max)
+{
+    if(value < min)
+    {
+        return min;
+    }
+    if(value > max)
+    {
+        return max;
+    }
+    return value;
+}
+
+// sin() of 0 to 90 degrees in 64 steps, as Q16.16
+static const q16_t q16SineTable[65] =
+{
+        0,  1608,  3216,  4821,  6424,  8022,  9616, 11204,
+    12785, 14359, 15924, 17479, 19024, 20557, 22078, 23586,
+    25080, 26558, 28020, 29466, 30893, 32303, 33692, 35062,
+    36410, 37736, 39040, 40320, 41576, 42806, 44011, 45190,
+    46341, 47464, 48559, 49624, 50660, 51665, 52639, 53581,
+    54491, 55368, 56212, 57022, 57798, 58538, 59244, 59914,
+    60547, 61145, 61705, 62228, 62714, 63162, 63572, 63944,
+    64277, 64571, 64827, 65043, 65220, 65358, 65457, 65516,
+    65536
+};
+
+// Binary angle for 90 degrees
+#define ANGLE_QUARTER_TURN 0x4000
+
+/**
+ * Converts an angle in degrees to a binary angle
+ *
+ * @param degrees The angle as Q16.16 degrees (any value, it wraps around)
+ * @return The binary angle
+ */
+static inline uint16_t angleFromDegrees(q16_t degrees)
+{
+    // 65536 binary angle units per 360 degrees, and the degrees are already scaled by 65536
+    return (uint16_t)(degrees / 360);
+}
+
+/**
+ * @param angle A binary angle
+ * @return The sine of the angle, linearly interpolated from a quarter wave table
+ */
+static inline q16_t q16Sin(uint16_t angle)
+{
+    unsigned int quadrant = angle >> 14;
+    unsigned int offset = angle & (ANGLE_QUARTER_TURN - 1);
+
+    // The second and fourth quadrants run the table backwards
+    if(quadrant & 1)
+    {
+        offset = ANGLE_QUARTER_TURN - offset;
+    }
+
+    unsigned int index = offset >> 8;
+    int fraction = offset & 0xFF;
+    q16_t value = q16SineTable[index];
+    if(index < 64)
+    {
+        value += ((q16SineTable[index + 1] - value) * fraction) >> 8;
+    }
+
+    // The second half of the turn is negative
+    return (quadrant & 2) ? -value : value;
+}
+
+/**
+ * @param angle A binary angle
+ * @return The cosine of the angle
+ */
+static inline q16_t q16Cos(uint16_t angle)
+{
+    return q16Sin((uint16_t)(angle + ANGLE_QUARTER_TURN));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,57 @@
+/** @file interrupts.h
+ * @brief Masking interrupts around short critical sections
+ *
+ * For the few places where a task and an interrupt both touch the same state, such as the hard
+ * stop masks (see motorOutFlush()) and the limit switch debounce (see switchesPoll()). Keep the
+ * masked sections to a few instructions, since every interrupt waits for them.
+ */
+
+#ifndef INTERRUPTS_H_
+#define INTERRUPTS_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Set to 0 where interrupts never preempt a task, such as the simulation
+#ifndef INTERRUPTS_MASK
+#define INTERRUPTS_MASK 1
+#endif
+
+/**
+ * Masks interrupts until interruptsRestore(). Sections can nest.
+ *
+ * @return The previous mask, for interruptsRestore()
+ */
+static inline uint32_t interruptsMask()
+{
+#if INTERRUPTS_MASK
+    uint32_t primask;
+    __asm__ volatile("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+    return primask;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Puts back the interrupt mask from interruptsMask()
+ *
+ * @param primask The previous mask
+ */
+static inline void interruptsRestore(uint32_t primask)
+{
+#if INTERRUPTS_MASK
+    __asm__ volatile("msr primask, %0" : : "r" (primask) : "memory");
+#else
+    (void)primask;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,97 @@
+/** @file joystick.h
+ * @brief Once per tick snapshot of the joystick
+ *
+ * Reading every axis and button once at the start of a tick means every subsystem sees the same
+ * inputs for that tick, and lets button edges be found by comparing against the last snapshot.
+ *
+ * Buttons are packed into a 16 bit mask with 4 bits per button group (5 to 8), using the
+ * JOY_DOWN, JOY_LEFT, JOY_UP and JOY_RIGHT values from API.h for the bit within the group.
+ */
+
+#ifndef JOYSTICK_H_
+#define JOYSTICK_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JOYSTICK_MASTER 1
+
+// Bit for a button in the JoystickState masks, e.g. JOY_BUTTON(8, JOY_UP)
+#define JOY_BUTTON(group, button) ((uint16_t)((button) << (((group) - 5) * 4)))
+
+/**
+ * Every input on one joystick at one point in time
+ */
+typedef struct
+{
+    // Axes 1 to 4, stored at index axis - 1. -127 to 127
+    int8_t axes[4];
+    // Buttons currently held down
+    uint16_t buttons;
+    // Buttons that went down since the last snapshot
+    uint16_t pressed;
+    // Buttons that came up since the last snapshot
+    uint16_t released;
+} JoystickState;
+
+/**
+ * Reads every axis and button of a joystick into a snapshot, computing the edges against the
+ * previous contents of the snapshot
+ *
+ * @param state The snapshot to update, holding the previous snapshot (zeroed the first time)
+ * @param joystick The joystick to read, 1 or 2
+ */
+void joystickUpdate(JoystickState *state, unsigned char joystick);
+
+/**
+ * Sets the buttons held in a snapshot, computing the edges against the previous contents of the
+ * snapshot. Used for inputs that don't come from a joystick, such as a replay (see replay.h).
+ *
+ * @param state The snapshot to update
+ * @param buttons The buttons now held
+ */
+void joystickSetButtons(JoystickState *state, uint16_t buttons);
+
+/**
+ * @return The value of an axis from 1 to 4. -127 to 127
+ */
+static inline int joystickAxis(const JoystickState *state, unsigned char axis)
+{
+    return state->axes[axis - 1];
+}
+
+/**
+ * @return true if the button is held down
+ */
+static inline bool joystickHeld(const JoystickState *state, unsigned char buttonGroup,
+    unsigned char button)
+{
+    return (state->buttons & JOY_BUTTON(buttonGroup, button)) != 0;
+}
+
+/**
+ * @return true if the button went down in this snapshot
+ */
+static inline bool joystickPressed(const JoystickState *state, unsigned char buttonGroup,
+    unsigned char button)
+{
+    return (state->pressed & JOY_BUTTON(buttonGroup, button)) != 0;
+}
+
+/**
+ * @return true if the button came up in this snapshot
+ */
+static inline bool joystickReleased(const JoystickState *state, unsigned char buttonGroup,
+    unsigned char button)
+{
+    return (state->released & JOY_BUTTON(buttonGroup, button)) != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+/** @file led.h
+ * @brief WS2812 addressable LED driver
+ *
+ * Pixels are set in a frame buffer with ledSetPixel() and pushed out to the strip by ledShow().
+ * The bitstream is generated by TIM1 in PWM mode on digital port 1 (PE9, TIM1 channel 1) with
+ * DMA1 channel 5 loading the duty cycle of every bit, so sending a frame doesn't block the CPU
+ * and can't be corrupted by interrupts. Both the timer and the DMA channel are unused by the PROS
+ * kernel, but nothing else may use them while the LEDs are in use.
+ */
+
+#ifndef LED_H_
+#define LED_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of pixels on the strip
+#define LED_COUNT 2
+
+/**
+ * Sets up the timer, DMA channel and pin for the LED strip and clears the frame buffer. Call
+ * this once from initialize().
+ */
+void ledInit();
+
+/**
+ * Sets the color of one pixel in the frame buffer. Nothing changes on the strip until ledShow().
+ *
+ * @param index The pixel to set, from 0 to LED_COUNT - 1
+ * @param red The red brightness. 0 to 255
+ * @param green The green brightness. 0 to 255
+ * @param blue The blue brightness. 0 to 255
+ */
+void ledSetPixel(unsigned int index, uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * Sets every pixel in the frame buffer to the same color
+ *
+ * @param red The red brightness. 0 to 255
+ * @param green The green brightness. 0 to 255
+ * @param blue The blue brightness. 0 to 255
+ */
+void ledFill(uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * Starts sending the frame buffer to the strip and returns immediately
+ *
+ * @return true if the frame was started, false if the previous frame is still being sent (call
+ * again on a later tick)
+ */
+bool ledShow();
+
+/**
+ * @return true while a frame is being sent
+ */
+bool ledBusy();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,32 @@
+/** @file macros.h
+ * @brief Multi-step actions shared by the driver and autonomous
+ *
+ * Each macro is a command (see command.h), so it runs alongside everything else in whichever
+ * task starts it.
+ */
+
+#ifndef MACROS_H_
+#define MACROS_H_
+
+#include <API.h>
+#include "command.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default voltage for backing up drive motors (see config.h for the tuned one)
+#define BACKUP_SPEED 70
+
+/**
+ * (Attempts to) drop off the stack of cubes the robot is holding: raises the tray, bumps the
+ * robot to settle the stack and then backs away from it while rolling out. Requires the drive,
+ * tray and rollers.
+ */
+extern Command dropOffCommand;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,13 +27,81 @@
 
 #include <API.h>
 
+// Memory comes from the arena in memory.h, never straight from the heap
+#pragma GCC poison malloc calloc realloc free
+
 // Allow usage of this file in C++ programs
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Define motor ports
+#define LEFT_MOTOR_FRONT 5
+#define LEFT_MOTOR_BACK 4
+#define RIGHT_MOTOR_FRONT 2
+#define RIGHT_MOTOR_BACK 3
+#define TRAY 6
+#define RIGHT_ROLLER 7
+#define LEFT_ROLLER 8
+#define RIGHT_ARM 9
+#define LEFT_ARM 10
+
+// Masks of the ports of each mechanism, for motorOutFlush() and command requirements
+#define DRIVE_PORTS (MOTOR_PORT_BIT(LEFT_MOTOR_FRONT) | MOTOR_PORT_BIT(LEFT_MOTOR_BACK) | \
+    MOTOR_PORT_BIT(RIGHT_MOTOR_FRONT) | MOTOR_PORT_BIT(RIGHT_MOTOR_BACK))
+#define TRAY_PORTS MOTOR_PORT_BIT(TRAY)
+#define ROLLER_PORTS (MOTOR_PORT_BIT(RIGHT_ROLLER) | MOTOR_PORT_BIT(LEFT_ROLLER))
+#define ARM_PORTS (MOTOR_PORT_BIT(RIGHT_ARM) | MOTOR_PORT_BIT(LEFT_ARM))
+
+// Every motor port has exactly one task that writes it, and each task only flushes its own
+// ports. Everything else asks the owner through its request function (armSetTarget(),
+// driveRequest(), traySetTarget()).
+//
+//   Task               Priority          Period  Ports
+//   Sensors            HIGHEST (5)       1 ms    -
+//   Odometry           HIGHEST - 1 (4)   10 ms   -
+//   Arm                DEFAULT + 1 (3)   5 ms    ARM_PORTS
+//   Drive              DEFAULT + 1 (3)   10 ms   DRIVE_PORTS
+//   Tray               DEFAULT + 1 (3)   10 ms   TRAY_PORTS
+//   Operator control   DEFAULT (2)       20 ms   The rest: ROLLER_PORTS and the LED power
+//   Autonomous         DEFAULT (2)       10 ms   ROLLER_PORTS
+//   Menu, status, telemetry, replay writer, config console, stack monitor: LOWEST + 1 (1), no
+//   ports
+//
+// Each task is strictly below the ones whose results it reads (sensors, then odometry), since
+// those readers retry while the writer is part way through an update. Operator control and
+// autonomous never run at the same time. Slow I/O (the LCD, serial reports, the LED strip and
+// flash) only happens in the LOWEST + 1 tasks.
+
+// Slew limits in voltage per flush. The drive is flushed every 10ms by the drive task and the
+// rollers from the 20ms control loop. From 0, the drive takes about 200ms to reach full power.
+// The arm and tray controllers limit their own acceleration.
+#define DRIVE_ACCEL 6
+#define DRIVE_DECEL 12
+#define ROLLER_ACCEL 32
+#define ROLLER_DECEL MOTOR_SLEW_UNLIMITED
+
+// Define sensor ports
 #define ARM_POTENTIOMETER 1
+#define GYRO_PORT 2
+#define TRAY_POTENTIOMETER 3
+
+// Drive shaft encoders (digital ports)
+#define LEFT_ENCODER_TOP 2
+#define LEFT_ENCODER_BOTTOM 3
+#define RIGHT_ENCODER_TOP 4
+#define RIGHT_ENCODER_BOTTOM 5
 
+// Limit switches at the ends of the tray's travel (digital ports, see switches.h)
+#define TRAY_LIMIT_DOWN 6
+#define TRAY_LIMIT_UP 7
+
+// The LED strip data line is on digital port 1 (see led.h)
+
+// The LCD is on UART 1 (see menu.h)
+#define LCD_PORT uart1
+// Characters in a line of the LCD, plus the terminator
+#define LCD_LINE_SIZE 17
 
 // A function prototype looks exactly like its declaration, but with a semicolon instead of
 // actual code. If a function does not match a prototype, compile errors will occur.
@@ -96,6 +164,14 @@ void initialize();
  * This task should never exit; it should end with some kind of infinite loop, even if empty.
  */
 void operatorControl();
+/**
+ * Runs the operator control jobs on the recording in flash instead of the joystick (see
+ * replay.h). Called by autonomous() when the replay is selected. Never returns, and the robot
+ * sits still once the recording ends.
+ *
+ * Returns straight away if there is no recording to play.
+ */
+void operatorReplay();
 
 // End C++ export structure
 #ifdef __cplusplus
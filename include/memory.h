@@ -0,0 +1,97 @@
+/** @file memory.h
+ * @brief Static arena and heap tracking
+ *
+ * Subsystems get their memory from a fixed size arena instead of the heap, so the robot's RAM
+ * use is known at build time and can't fragment over a day of matches. The arena only hands
+ * out memory during initialize(); memoryLock() closes it once initialize() is done. Nothing in
+ * the robot code allocates and frees while running, so there is no allocator for that.
+ *
+ * malloc() and friends are poisoned for our own code (see main.h). The kernel still uses the
+ * heap for tasks, semaphores and files, so the heap is wrapped at link time to keep track of
+ * how much of it is in use. Heap allocations after memoryLock() are counted (see
+ * memoryPrint()) rather than refused, since the kernel still has to make some, such as the
+ * stack of the operator control or autonomous task every time the robot is enabled.
+ */
+
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of the arena in bytes
+#define MEMORY_ARENA_SIZE 8192
+
+// Every allocation is aligned to this many bytes
+#define MEMORY_ALIGNMENT 8
+
+// Most arena allocations tracked for memoryPrint()
+#define MEMORY_MAX_ALLOCATIONS 24
+
+// Most live heap blocks tracked. Blocks past this still work, they just aren't counted.
+#define MEMORY_HEAP_BLOCKS 48
+
+// Value painted over watched heap allocations, see memoryWatchAllocation()
+#define MEMORY_PAINT 0xA5A5A5A5
+
+/**
+ * Allocates memory from the arena for the life of the program. Only works until memoryLock().
+ *
+ * @param size The number of bytes needed
+ * @param owner Name of what the memory is for, shown by memoryPrint()
+ * @return The zeroed memory, or NULL if the arena is full or locked
+ */
+void *memoryAlloc(size_t size, const char *owner);
+
+/**
+ * Paints the next heap allocation of the given size with MEMORY_PAINT, so how much of it was
+ * ever used can be worked out later. Used to paint task stacks, which the kernel allocates
+ * from the heap in taskCreate().
+ *
+ * @param size The size of the allocation to paint, in bytes
+ */
+void memoryWatchAllocation(size_t size);
+
+/**
+ * Stops watching for allocations
+ *
+ * @return The block painted since memoryWatchAllocation(), or NULL if there wasn't one
+ */
+void *memoryWatchedBlock();
+
+/**
+ * @return The number of heap bytes in use
+ */
+size_t memoryHeapUsed();
+
+/**
+ * @return Roughly how much RAM is left for the heap. Doesn't account for fragmentation or the
+ * interrupt stack at the top of RAM.
+ */
+size_t memoryHeapFree();
+
+/**
+ * Closes the arena. Called at the end of initialize().
+ */
+void memoryLock();
+
+/**
+ * @return The number of arena bytes handed out, including alignment padding
+ */
+size_t memoryArenaUsed();
+
+/**
+ * Prints the arena allocations, heap use and any failed or late allocations
+ *
+ * @param stream The stream to print to, such as stdout
+ */
+void memoryPrint(PROS_FILE *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,46 @@
+/** @file menu.h
+ * @brief LCD menu and autonomous selector
+ *
+ * A low priority task polls the LCD buttons and redraws the screen. LEFT and RIGHT move
+ * between screens and CENTER acts on the current one:
+ *
+ * - Autonomous: CENTER picks the next path in autonPaths, or the replay, and saves it
+ * - Recording: CENTER arms or disarms recording the next driver run (see replay.h)
+ * - One screen per tuning field: CENTER starts editing, LEFT and RIGHT change the value by its
+ *   step, and CENTER again stops editing and saves
+ * - One screen per timing section and per monitored task stack
+ * - Battery voltages and the arm position
+ *
+ * Lines are only sent to the LCD when their text changes, so an idle menu costs almost nothing
+ * on the UART.
+ */
+
+#ifndef MENU_H_
+#define MENU_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The menu should never hold up anything that drives the robot
+#define MENU_PRIORITY (TASK_PRIORITY_LOWEST + 1)
+#define MENU_STACK_SIZE (TASK_MINIMAL_STACK_SIZE * 2)
+
+// How often the buttons are read, in ms
+#define MENU_POLL_PERIOD 50
+// How often a screen is redrawn when no button is pressed, in ms
+#define MENU_REDRAW_PERIOD 250
+
+/**
+ * Sets up the LCD on LCD_PORT and starts the menu task. Call this from initialize(), after
+ * configLoad().
+ */
+void menuInit();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,185 @@
+/** @file motor.h
+ * @brief Buffered motor outputs
+ *
+ * Handlers request a value for a motor port instead of calling motorSet() directly. Requests
+ * made during a tick are resolved by priority (the highest priority request wins, ties go to
+ * the last one made) and motorOutFlush() then writes only the ports whose value changed.
+ *
+ * Values are logical: ports marked as inverted have their sign flipped on the way out, so a
+ * positive value always means the same direction for a mechanism.
+ *
+ * Each port can also have a slew limit, which caps how much its output may speed up (accel) or
+ * slow down (decel) per flush. This keeps step changes in the commanded voltage from causing the
+ * current spikes that trip the PTC breakers.
+ *
+ * Outputs are scaled for the battery voltage on the way out, so a value gives the same motor
+ * voltage from a fresh battery as from a flat one. The scale comes from the filtered battery
+ * reading (see motorOutSetBattery()) and is worked out once per reading, so a flush only costs
+ * a multiply per port. Full power can't be compensated, so values near 127 give less on a low
+ * battery.
+ *
+ * A port can be stopped from moving in one direction, for a mechanism sitting against a hard
+ * stop. This is set from the limit switch interrupts (see switches.h), and a port pushing into
+ * the stop is stopped at its owner's next flush.
+ *
+ * Each task should only request and flush the ports it owns. Ports are independent, so two
+ * tasks can flush different ports at the same time.
+ */
+
+#ifndef MOTOR_H_
+#define MOTOR_H_
+
+#include <API.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of motor ports on the Cortex
+#define MOTOR_PORTS 10
+
+// Masks of motor ports for motorOutFlush()
+#define MOTOR_PORT_BIT(port) ((uint16_t)(1 << ((port) - 1)))
+#define MOTOR_ALL_PORTS ((uint16_t)((1 << MOTOR_PORTS) - 1))
+
+// Slew rate that doesn't limit anything
+#define MOTOR_SLEW_UNLIMITED 255
+
+// Battery voltage that outputs are scaled to, in mV. Around the middle of a match.
+#define MOTOR_NOMINAL_VOLTAGE 7800
+// Readings below this aren't compensated for, since the Cortex is probably running from USB
+// with the battery off
+#define MOTOR_BATTERY_MIN 5000
+// Limits of the scale, so a bad reading can't do much
+#define MOTOR_SCALE_MIN Q16(0.8)
+#define MOTOR_SCALE_MAX Q16(1.3)
+
+// Thermal model of the PTC breaker in each motor (see motorOutHeat()). Currents are fractions
+// of the stall current at MOTOR_NOMINAL_VOLTAGE, and heat is normalized so the breaker trips at
+// Q16_ONE, the heat that MOTOR_HOLD_CURRENT (about 1A of a 393's 4.8A stall) settles at.
+// With a 2 minute time constant a stall from cold trips in about 5s.
+#define MOTOR_HOLD_CURRENT Q16(0.21)
+#define MOTOR_THERMAL_TIME_CONSTANT 120000
+// Above MOTOR_HEAT_SOFT the current allowed falls, reaching MOTOR_SAFE_CURRENT (which settles
+// below the trip point) at MOTOR_HEAT_HARD
+#define MOTOR_HEAT_SOFT Q16(0.6)
+#define MOTOR_HEAT_HARD Q16(0.9)
+#define MOTOR_SAFE_CURRENT Q16(0.18)
+// Ports whose owner doesn't set a speed are assumed to run at this fraction of the speed their
+// voltage would give them unloaded
+#define MOTOR_UNKNOWN_LOAD_SPEED Q16(0.5)
+
+// Request priorities, from lowest to highest
+#define MOTOR_PRIORITY_DRIVER 1
+#define MOTOR_PRIORITY_OVERRIDE 2
+#define MOTOR_PRIORITY_MACRO 3
+
+/**
+ * Resets every port to 0, not inverted and without a slew limit. Call this once from
+ * initialize() before using any of the other functions.
+ */
+void motorOutInit();
+
+/**
+ * Sets whether a port's output is inverted
+ *
+ * @param port The motor port, 1 to 10
+ * @param inverted true to flip the sign of every value written to the port
+ */
+void motorOutSetInverted(unsigned char port, bool inverted);
+
+/**
+ * Sets the slew limit of a port. The limits are applied every time the port is flushed, so
+ * they are in units of the flushing task's period.
+ *
+ * @param port The motor port, 1 to 10
+ * @param accel The most the output may move away from 0 per flush. 1 to MOTOR_SLEW_UNLIMITED
+ * @param decel The most the output may move towards 0 per flush. 1 to MOTOR_SLEW_UNLIMITED
+ */
+void motorOutSetSlew(unsigned char port, unsigned int accel, unsigned int decel);
+
+/**
+ * Requests a value for a port for this tick. The request only replaces an earlier one from the
+ * same tick if its priority is at least as high. Ports nobody requests keep their last value.
+ *
+ * @param port The motor port, 1 to 10
+ * @param speed The logical speed, -127 to 127
+ * @param priority The priority of the request, one of the MOTOR_PRIORITY_* values
+ */
+void motorOutRequest(unsigned char port, int speed, unsigned int priority);
+
+/**
+ * Moves the output of each given port towards its requested value (within its slew limit),
+ * writes the ports whose output changed and clears the requests so the next tick starts fresh
+ *
+ * @param ports A mask of ports built from MOTOR_PORT_BIT()
+ */
+void motorOutFlush(uint16_t ports);
+
+/**
+ * Sets the battery voltage that outputs are compensated for. Called by the sensor task with
+ * the filtered battery reading.
+ *
+ * @param millivolts The main battery voltage in mV
+ */
+void motorOutSetBattery(unsigned int millivolts);
+
+/**
+ * @return The scale applied to every output for the battery voltage
+ */
+q16_t motorOutScale();
+
+/**
+ * Stops ports from moving in one direction, or lets them again. Safe to call from an interrupt,
+ * as long as only interrupts (or initialize()) call it. Only the owning task writes its ports,
+ * so ports already moving that way stop at its next flush.
+ *
+ * @param ports A mask of ports built from MOTOR_PORT_BIT()
+ * @param direction 1 to stop positive logical values, -1 to stop negative ones
+ * @param engaged true to stop that direction, false to allow it again
+ */
+void motorOutSetHardStop(uint16_t ports, int direction, bool engaged);
+
+/**
+ * Forgets what was last written to some ports so the next flush writes all of them, and
+ * assumes their motors are stopped so the slew limits ramp up from 0. Call this when something
+ * outside of this module might have changed the motors, such as the kernel stopping them
+ * while the robot was disabled. Like flushing, only call it from the task that owns the ports.
+ *
+ * @param ports A mask of ports built from MOTOR_PORT_BIT()
+ */
+void motorOutInvalidate(uint16_t ports);
+
+/**
+ * Tells the thermal model how fast the motors on some ports are turning. Call this before every
+ * flush of the ports, from the task that owns them.
+ *
+ * @param ports A mask of ports built from MOTOR_PORT_BIT()
+ * @param speed The speed as a fraction of the free speed at MOTOR_NOMINAL_VOLTAGE, positive in
+ *        the direction of a positive logical value
+ */
+void motorOutSetSpeed(uint16_t ports, q16_t speed);
+
+/**
+ * Gets the estimated heat of a port's breaker. Every flush adds the square of the current
+ * estimated from the output and the speed (see motorOutSetSpeed()) and lets some heat out,
+ * and once the heat passes MOTOR_HEAT_SOFT the output is limited so the breaker never trips.
+ *
+ * @param port The motor port, 1 to 10
+ * @return The heat, where Q16_ONE is the breaker tripping
+ */
+q16_t motorOutHeat(unsigned char port);
+
+/**
+ * @param port The motor port, 1 to 10
+ * @return The logical value currently being output on the port, after slew limiting and
+ *         before battery compensation
+ */
+int motorOutGet(unsigned char port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
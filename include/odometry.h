@@ -0,0 +1,107 @@
+/** @file odometry.h
+ * @brief Drive base position tracking
+ *
+ * A task integrates the left and right drive encoders every ODOMETRY_PERIOD into an x/y
+ * position and heading, with the heading corrected towards the gyro. The pose and the speed of
+ * each side of the drive are published through a sequence lock, so any task can read them
+ * without blocking the odometry task.
+ *
+ * The field frame starts out with the robot at (0, 0) facing along +x. Positive headings turn
+ * left (counterclockwise).
+ */
+
+#ifndef ODOMETRY_H_
+#define ODOMETRY_H_
+
+#include <API.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Set to 1 to read the drive from the integrated motor encoders instead of shaft encoders
+#ifndef ODOMETRY_USE_IME
+#define ODOMETRY_USE_IME 0
+#endif
+
+// IME chain addresses of the drive motors, used when ODOMETRY_USE_IME is 1
+#define LEFT_DRIVE_IME 0
+#define RIGHT_DRIVE_IME 1
+
+// Period of the odometry task in ms
+#define ODOMETRY_PERIOD 10
+
+// The odometry task has to be above every task that reads the pose (the drive task at
+// DEFAULT + 1, autonomous and the LOWEST + 1 tasks), since a reader retries for as long as the
+// writer is part way through an update
+#define ODOMETRY_TASK_PRIORITY (TASK_PRIORITY_HIGHEST - 1)
+#define ODOMETRY_STACK_SIZE TASK_DEFAULT_STACK_SIZE
+
+// Distance travelled per encoder tick in inches. 4" wheels, 360 ticks per turn (shaft encoder)
+// or 627.2 (393 IME in high torque mode).
+#if ODOMETRY_USE_IME
+#define ODOMETRY_INCHES_PER_TICK Q16(3.14159 * 4 / 627.2)
+#else
+#define ODOMETRY_INCHES_PER_TICK Q16(3.14159 * 4 / 360)
+#endif
+
+// Distance between the left and right wheels in inches
+#define ODOMETRY_TRACK_WIDTH 14.0
+
+// How far the heading is pulled towards the gyro every update. 0 ignores the gyro, 1 uses
+// only the gyro. The gyro doesn't slip, but it only reports whole degrees.
+#define ODOMETRY_GYRO_WEIGHT Q16(0.05)
+
+// How much of each new wheel speed is blended in. At 10ms a single shaft encoder tick is
+// 3.5 inches per second, so the raw speed needs a lot of smoothing.
+#define ODOMETRY_SPEED_WEIGHT Q16(0.25)
+
+/**
+ * Position and heading of the robot on the field
+ */
+typedef struct
+{
+    // Inches
+    q16_t x;
+    q16_t y;
+    // Degrees, counterclockwise. Cumulative, it does not wrap at 360.
+    q16_t heading;
+} Pose;
+
+/**
+ * Sets up the encoders and gyro and starts the odometry task. Call this once from initialize()
+ * while the robot is still, since it calibrates the gyro.
+ */
+void odometryInit();
+
+/**
+ * Reads the latest pose. Never blocks, but must only be called from tasks with a lower priority
+ * than ODOMETRY_TASK_PRIORITY.
+ *
+ * @param pose Set to the latest pose
+ */
+void odometryGetPose(Pose *pose);
+
+/**
+ * Reads the latest speed of each side of the drive. Never blocks, but must only be called from
+ * tasks with a lower priority than ODOMETRY_TASK_PRIORITY.
+ *
+ * @param left Set to the left side's speed in inches per second, positive forwards
+ * @param right Set to the right side's speed in inches per second, positive forwards
+ */
+void odometryGetWheelSpeeds(q16_t *left, q16_t *right);
+
+/**
+ * Moves the tracked pose, for example to the robot's starting position before autonomous. The
+ * odometry task applies the new pose on its next update.
+ *
+ * @param pose The new pose
+ */
+void odometrySetPose(const Pose *pose);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+/** @file path.h
+ * @brief Autonomous path following
+ *
+ * A path is a list of legs that each turn in place or drive straight. Every leg has a motion
+ * profile (position, velocity and acceleration every PATH_PERIOD) planned ahead of time by
+ * tools/genpaths.py and stored in flash, so following a path only has to look up the next
+ * point and correct for the odometry error.
+ *
+ * The follower drives with feedforward from the profile's velocity and acceleration, plus
+ * proportional feedback on how far the odometry pose is from where the profile says the robot
+ * should be. Paths are driven by a command, so other mechanisms can run alongside them.
+ */
+
+#ifndef PATH_H_
+#define PATH_H_
+
+#include <API.h>
+#include "command.h"
+#include "fixed.h"
+#include "odometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Period of the profiles and the follower in ms, must match PERIOD in tools/genpaths.py
+#define PATH_PERIOD 10
+
+/**
+ * What a leg does
+ */
+typedef enum
+{
+    // Turn in place, the profile is in degrees relative to the starting heading
+    PATH_LEG_TURN,
+    // Drive straight along the heading, the profile is in inches from the starting point
+    PATH_LEG_DRIVE
+} PathLegType;
+
+/**
+ * One sample of a motion profile
+ */
+typedef struct
+{
+    // Inches or degrees since the start of the leg
+    q16_t position;
+    // Per second
+    q16_t velocity;
+    // Per second per second
+    q16_t acceleration;
+} ProfilePoint;
+
+/**
+ * One turn or drive of a path
+ */
+typedef struct
+{
+    PathLegType type;
+    // Where the leg starts, in inches
+    q16_t startX;
+    q16_t startY;
+    // The heading at the start of a turn, or the heading held during a drive, in degrees
+    q16_t heading;
+    const ProfilePoint *profile;
+    uint16_t length;
+} PathLeg;
+
+/**
+ * A list of legs and the pose that the robot starts them from
+ */
+typedef struct
+{
+    const char *name;
+    Pose start;
+    const PathLeg *legs;
+    uint8_t legCount;
+} Path;
+
+// Every generated path, for picking one to run
+extern const Path *const autonPaths[];
+extern const unsigned int autonPathCount;
+
+// Command functions, used by PATH_COMMAND
+void pathCommandInit(Command *command);
+void pathCommandExecute(Command *command);
+bool pathCommandIsFinished(Command *command);
+void pathCommandEnd(Command *command, bool interrupted);
+
+/**
+ * Declares a command that drives a path (see command.h). It moves the odometry pose to the
+ * path's starting pose and then follows each leg in turn. A leg ends once its profile is done
+ * and the robot is within tolerance, or PATH_SETTLE_TIMEOUT after the end of the profile.
+ *
+ * The profile is followed by time, so the command can run at any rate, but it tracks best when
+ * the task running it ticks every PATH_PERIOD.
+ *
+ * @param commandName The name of the command
+ * @param path Pointer to the path to drive. It can also be set later with the command's data.
+ */
+#define PATH_COMMAND(commandName, path) \
+    {.name = (commandName), .init = pathCommandInit, .execute = pathCommandExecute, \
+    .isFinished = pathCommandIsFinished, .end = pathCommandEnd, .requirements = DRIVE_PORTS, \
+    .data = (path)}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
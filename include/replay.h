@@ -0,0 +1,137 @@
+/** @file replay.h
+ * @brief Recording a driver run to flash and replaying it
+ *
+ * A recording is the stream of joystick snapshots from one operator control run, one per
+ * control tick. Playing it back through the same control jobs drives the robot the same way, so
+ * a skills run can be recorded once and replayed as the autonomous routine, or a recording from
+ * the robot can be run again in the simulator (see sim/main.c).
+ *
+ * Recordings are delta-encoded so a full run fits in flash. After a 4 byte header ('R', 'P',
+ * REPLAY_VERSION and the tick period in ms), each frame is:
+ *
+ * - the number of ticks since the last frame, 0 to 255 (0 only for the first frame)
+ * - a mask of what changed: bits 0 to 3 for axes 1 to 4, REPLAY_BUTTONS for the buttons, or
+ *   REPLAY_END at the end of the recording. 0 is a frame that only moves the time on.
+ * - the new value of each axis that changed (1 byte each) and then the buttons (2 bytes, little
+ *   endian) if they changed
+ *
+ * Inputs hold their value between frames. A tick only costs space when something changes, and
+ * then only for what changed.
+ *
+ * While recording, the control task queues frames in a lock-free ring buffer (the same scheme as
+ * telemetry.c) and a low priority task writes them to flash, so the control loop never waits on
+ * the flash. The recording ends when the robot is disabled, when it reaches REPLAY_MAX_SIZE, or
+ * if the writer falls too far behind. Like config saves, every recording uses up flash until the
+ * next power cycle.
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <API.h>
+#include "joystick.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define REPLAY_FILE "replay"
+#define REPLAY_VERSION 1
+
+// Frame mask bits
+#define REPLAY_BUTTONS 0x10
+#define REPLAY_END 0x80
+
+// Largest recording, in bytes. A minute of driving is usually well under this.
+#define REPLAY_MAX_SIZE 16384
+
+// Bytes the ring buffer holds between the control task and the writer. Must be a power of 2.
+#define REPLAY_BUFFER_SIZE 256
+
+// The writer runs just above idle, like the telemetry task
+#define REPLAY_TASK_PRIORITY (TASK_PRIORITY_LOWEST + 1)
+#define REPLAY_STACK_SIZE TASK_DEFAULT_STACK_SIZE
+
+// How often the writer checks for new frames, in ms
+#define REPLAY_DRAIN_PERIOD 20
+
+/**
+ * What the recorder is doing, for the menu
+ */
+typedef enum
+{
+    // Nothing recorded since startup
+    REPLAY_IDLE,
+    // The next operator control run will be recorded
+    REPLAY_ARMED,
+    REPLAY_RECORDING,
+    // The last recording was written to flash
+    REPLAY_SAVED,
+    // The last recording couldn't be written, or the writer fell behind. Whatever made it to
+    // flash is still a valid (shorter) recording.
+    REPLAY_FAILED
+} ReplayState;
+
+/**
+ * Starts the writer task. Call this once from initialize().
+ */
+void replayInit();
+
+/**
+ * Arms or disarms recording the next operator control run
+ */
+void replayArm(bool armed);
+
+/**
+ * @return What the recorder is doing
+ */
+ReplayState replayState();
+
+/**
+ * @return The size of the current or last recording in bytes
+ */
+size_t replaySize();
+
+/**
+ * Starts recording if replayArm() was called. Call this at the start of operator control, from
+ * the task that will call replayRecord().
+ *
+ * @param period The tick period in ms
+ */
+void replayRecordStart(unsigned int period);
+
+/**
+ * Adds one tick to the recording, if one is running. Never blocks.
+ *
+ * @param state This tick's joystick snapshot
+ */
+void replayRecord(const JoystickState *state);
+
+/**
+ * Opens the recording in flash for playback
+ *
+ * @param period The tick period in ms, which must match the recording's
+ * @return true if there is a recording with that period
+ */
+bool replayStart(unsigned int period);
+
+/**
+ * Plays back one tick. Once the recording ends the snapshot has everything released.
+ *
+ * @param state The snapshot to update, holding the previous snapshot (zeroed the first time)
+ * @return false once the recording has ended
+ */
+bool replayNext(JoystickState *state);
+
+/**
+ * Prints the recording in flash as lines of hex, which "xxd -r -p" turns back into the file
+ *
+ * @param stream The stream to print to
+ */
+void replayPrint(PROS_FILE *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
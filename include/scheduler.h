@@ -0,0 +1,101 @@
+/** @file scheduler.h
+ * @brief Fixed-rate scheduler for periodic control jobs
+ *
+ * The scheduler runs a set of registered jobs from the task that calls schedulerRun(). Time is
+ * divided into ticks of SCHEDULER_TICK_MS milliseconds, kept on a fixed rate with
+ * taskDelayUntil(), so the loop period does not depend on how much work was done in a tick.
+ * Each job runs every `period` milliseconds and jobs that are due in the same tick run in order
+ * of priority, highest first.
+ *
+ * Every job is timed as a section of the same name (see timing.h), along with the "tick"
+ * section (all jobs in a tick) and the "jitter" section (how far the start of each tick was
+ * from SCHEDULER_TICK_MS after the last one).
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Length of one scheduler tick in milliseconds. Job periods must be a multiple of this.
+#define SCHEDULER_TICK_MS 10
+
+// Number of jobs that can be registered at once
+#define SCHEDULER_MAX_JOBS 10
+
+/**
+ * Function run by the scheduler every time a job is due
+ */
+typedef void (*JobCode)(void);
+
+/**
+ * Bookkeeping for one registered job
+ */
+typedef struct
+{
+    const char *name;
+    JobCode code;
+    // How often the job runs, in scheduler ticks
+    unsigned int periodTicks;
+    unsigned int priority;
+    // Number of times the job took longer than its own period
+    unsigned long overruns;
+    // Timing section ID for the job
+    int timing;
+} Job;
+
+/**
+ * Removes every registered job and clears the overrun counters
+ */
+void schedulerReset();
+
+/**
+ * Registers a periodic job. Jobs can only be added before schedulerRun() is called.
+ *
+ * @param name A short name for the job, used in reports
+ * @param code The function to run
+ * @param period How often to run the job in milliseconds (a multiple of SCHEDULER_TICK_MS)
+ * @param priority Order of the job within a tick, higher runs first
+ * @return true if the job was added, false if the table is full or the period is invalid
+ */
+bool schedulerAdd(const char *name, JobCode code, unsigned long period, unsigned int priority);
+
+/**
+ * Runs the registered jobs forever on a fixed tick. This function never returns.
+ */
+void schedulerRun();
+
+/**
+ * @return The number of ticks whose jobs did not finish before the next tick was due
+ */
+unsigned long schedulerTickOverruns();
+
+/**
+ * @return The number of registered jobs
+ */
+unsigned int schedulerJobCount();
+
+/**
+ * Gets the bookkeeping for a job
+ *
+ * @param index The job index, from 0 to schedulerJobCount() - 1 in priority order
+ * @return The job, or NULL if the index is out of range
+ */
+const Job *schedulerGetJob(unsigned int index);
+
+/**
+ * Prints the overrun counts of every job. The run times are printed by timingPrint().
+ *
+ * @param stream The stream to print to (stdout, uart1 or uart2)
+ */
+void schedulerPrintStats(PROS_FILE *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+/** @file sensors.h
+ * @brief Filtered analog sensor service
+ *
+ * A high priority task samples every enabled analog channel with analogReadCalibratedHR()
+ * every SENSOR_SAMPLE_PERIOD. Each sample goes through a median of 3 to throw out single
+ * sample spikes, and every SENSOR_DECIMATION samples are averaged into a new reading. The
+ * reading's velocity is the smoothed change between readings.
+ *
+ * The main battery is read every SENSOR_BATTERY_PERIOD and smoothed, and the motor outputs are
+ * compensated for it (see motorOutSetBattery()).
+ *
+ * Readings are published through a sequence lock per channel, like the odometry pose, so they
+ * can be read from any task below SENSOR_TASK_PRIORITY without blocking the sensor task.
+ */
+
+#ifndef SENSORS_H_
+#define SENSORS_H_
+
+#include <API.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of analog channels on the Cortex
+#define SENSOR_CHANNELS 8
+
+// How often every channel is sampled, in ms
+#define SENSOR_SAMPLE_PERIOD 1
+// Samples averaged into each reading, so a new reading comes out every 5ms
+#define SENSOR_DECIMATION 5
+
+// How much of each new velocity estimate is blended in. Lower is smoother but lags more.
+#define SENSOR_VELOCITY_WEIGHT Q16(0.3)
+
+// How often the battery is read, in ms, and how much of each reading is blended in. Motors
+// starting up pull the battery down for a moment, so it is smoothed over about a second.
+#define SENSOR_BATTERY_PERIOD 20
+#define SENSOR_BATTERY_WEIGHT Q16(0.02)
+
+// The sensor task has to be above every task that reads it
+#define SENSOR_TASK_PRIORITY TASK_PRIORITY_HIGHEST
+#define SENSOR_STACK_SIZE (TASK_MINIMAL_STACK_SIZE * 2)
+
+/**
+ * A filtered reading of an analog channel
+ */
+typedef struct
+{
+    // Calibrated value (see analogReadCalibrated()), with the fractional bits from
+    // oversampling
+    q16_t value;
+    // Change in the calibrated value per second
+    q16_t velocity;
+    // Incremented for every new reading
+    uint32_t count;
+} SensorReading;
+
+/**
+ * Calibrates an analog channel (see analogCalibrate(), the sensor must be still) and starts
+ * filtering it. Call this from initialize().
+ *
+ * @param channel The analog channel, 1 to 8
+ */
+void sensorsAddAnalog(unsigned char channel);
+
+/**
+ * Starts the sensor task. Call this once from initialize().
+ */
+void sensorsInit();
+
+/**
+ * Gets the latest reading of a channel. Never blocks, but must not be called from a task with
+ * a higher priority than SENSOR_TASK_PRIORITY.
+ *
+ * @param channel The analog channel, 1 to 8
+ * @param reading Set to the latest reading, all zero if the channel hasn't been added or read
+ */
+void sensorGet(unsigned char channel, SensorReading *reading);
+
+/**
+ * @return The smoothed main battery voltage in mV
+ */
+unsigned int sensorBattery();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+/** @file stack.h
+ * @brief Task stack high-watermark monitor
+ *
+ * Tasks created with stackTaskCreate() have their stacks painted with a known value before
+ * they start. A low priority task scans the stacks every STACK_MONITOR_PERIOD to find how
+ * deep each one has ever been used, which stackPrint() turns into a recommended stack size
+ * table that can be pasted back into the source.
+ *
+ * The kernel's own tasks (including the autonomous and operator control tasks) aren't created
+ * here, so they can't be monitored.
+ */
+
+#ifndef STACK_H_
+#define STACK_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Most tasks that can be monitored
+#define STACK_MAX_TASKS 12
+
+// How often the monitor scans the stacks, in ms
+#define STACK_MONITOR_PERIOD 1000
+
+// The monitor runs just above idle, so scanning never delays real work
+#define STACK_MONITOR_PRIORITY (TASK_PRIORITY_LOWEST + 1)
+#define STACK_MONITOR_STACK_SIZE 128
+
+// Headroom added to the deepest use seen when recommending a stack size, as a percentage and a
+// minimum in words. Recommendations are rounded up to a multiple of 16 words.
+#define STACK_MARGIN_PERCENT 25
+#define STACK_MARGIN_MIN 32
+
+/**
+ * Creates a task with a monitored stack. Takes the same arguments as taskCreate(), plus a name.
+ * Only call this from initialize(), since painting the stack relies on no other task
+ * allocating a block of the same size at the same time.
+ *
+ * @param name Name of the task in upper case, used for its NAME_STACK_SIZE define in the
+ * stackPrint() table
+ * @param taskCode The function the task runs
+ * @param stackDepth The stack size in words (4 bytes each)
+ * @param parameters Passed to taskCode
+ * @param priority The task priority
+ * @return The task handle, or NULL if the task couldn't be created
+ */
+TaskHandle stackTaskCreate(const char *name, TaskCode taskCode, const unsigned int stackDepth,
+    void *parameters, const unsigned int priority);
+
+/**
+ * Starts the monitor task. Call this once from initialize().
+ */
+void stackMonitorInit();
+
+/**
+ * @return The number of monitored tasks
+ */
+unsigned int stackTaskCount();
+
+/**
+ * @return The fewest free stack words of any monitored task, as of the last scan
+ */
+unsigned int stackLowestFree();
+
+/**
+ * Prints each monitored task's stack use and a table of recommended stack size defines
+ *
+ * @param stream The stream to print to, such as stdout
+ */
+void stackPrint(PROS_FILE *stream);
+
+/**
+ * Formats one task's stack use as two LCD lines: its name and size, then the deepest use and
+ * free words
+ *
+ * @param index The task index, 0 to stackTaskCount() - 1
+ * @param top Set to the first line, LCD_LINE_SIZE characters
+ * @param bottom Set to the second line, LCD_LINE_SIZE characters
+ */
+void stackLcd(unsigned int index, char *top, char *bottom);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,48 @@
+/** @file status.h
+ * @brief Low priority reporting and the LED strip
+ *
+ * Everything the operator control loop used to do that could wait on a slow peripheral runs in
+ * this task instead: the serial reports (scheduler overruns, the timing, memory and stack
+ * stats, and the arm's learned feedforward table) and pushing frames to the LED strip. The
+ * control loop only sets flags here, so a report filling the serial buffer can never make it miss
+ * a tick. This task is the only one that touches the LED strip.
+ */
+
+#ifndef STATUS_H_
+#define STATUS_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Just above idle, with the menu and telemetry
+#define STATUS_PRIORITY (TASK_PRIORITY_LOWEST + 1)
+#define STATUS_STACK_SIZE TASK_DEFAULT_STACK_SIZE
+
+// How often requests are picked up, and how often the scheduler is checked for new overruns,
+// in ms
+#define STATUS_POLL_PERIOD 50
+#define STATUS_OVERRUN_PERIOD 1000
+
+/**
+ * Starts the status task. Call this once from initialize().
+ */
+void statusInit();
+
+/**
+ * Asks for the timing, memory and stack report to be printed to stdout
+ */
+void statusRequestReport();
+
+/**
+ * Asks for the LED strip to be turned off
+ */
+void statusRequestLedsOff();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
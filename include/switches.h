@@ -0,0 +1,94 @@
+/** @file switches.h
+ * @brief Interrupt driven limit switches
+ *
+ * Each switch has a pin change interrupt (see ioSetInterrupt()). The interrupt debounces the
+ * switch against micros() timestamps, engages the hard stop it guards (see
+ * motorOutSetHardStop()) so the motors pushing into it stop at their owner's next flush, and
+ * posts an event to a queue. An edge inside the debounce time isn't thrown away: the owner of
+ * the guarded motors calls switchesPoll() every tick, which reads the pin again once it has
+ * settled, so a tap shorter than the debounce time can't leave a hard stop engaged.
+ *
+ * The queue is written only by the switch interrupts and has no lock. Any number of tasks can
+ * read every event from it, each through its own SwitchListener. A listener that falls more
+ * than SWITCH_QUEUE_SIZE events behind loses the oldest ones.
+ *
+ * Switches are wired between the pin and ground, so a pressed switch reads low.
+ */
+
+#ifndef SWITCHES_H_
+#define SWITCHES_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Events kept in the queue, a power of 2
+#define SWITCH_QUEUE_SIZE 16
+
+// Edges this soon after the last accepted change of a switch are bounce, in microseconds
+#define SWITCH_DEBOUNCE_TIME 5000
+
+/**
+ * A debounced change of a switch
+ */
+typedef struct
+{
+    // micros() when the change happened
+    uint32_t time;
+    // The digital pin
+    unsigned char pin;
+    bool pressed;
+} SwitchEvent;
+
+/**
+ * Where one task is up to in the event queue. Only touch it through the functions below.
+ */
+typedef struct
+{
+    uint32_t next;
+    // Events lost because the listener fell behind
+    uint32_t dropped;
+} SwitchListener;
+
+/**
+ * Sets up the switch pins and their interrupts. Call this once from initialize(), after
+ * motorOutInit().
+ */
+void switchesInit();
+
+/**
+ * Takes the level of any switch that changed inside its debounce time, once
+ * SWITCH_DEBOUNCE_TIME has passed since its last change. Call this every tick from the task
+ * that owns the guarded motors, before it flushes them.
+ */
+void switchesPoll();
+
+/**
+ * Skips a listener past every event so far, so it only sees new ones
+ *
+ * @param listener The listener
+ */
+void switchesListen(SwitchListener *listener);
+
+/**
+ * Takes the next event for a listener. Never blocks.
+ *
+ * @param listener The listener
+ * @param event Set to the event
+ * @return true if there was an event
+ */
+bool switchesNext(SwitchListener *listener, SwitchEvent *event);
+
+/**
+ * @param pin The digital pin of a switch
+ * @return Whether the switch is pressed, as of its last debounced change
+ */
+bool switchPressed(unsigned char pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+/** @file telemetry.h
+ * @brief Binary telemetry log streamed over serial
+ *
+ * The control loop pushes one compact record per tick into a lock-free ring buffer and a low
+ * priority task drains it to a serial stream, so logging never stalls the loop on the serial
+ * port. If the buffer is full the record is dropped and counted instead of blocking.
+ *
+ * Only one task may call telemetrySample(). Records are decoded on the host with
+ * tools/telemetry_decode.py.
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <API.h>
+#include "motor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of records the ring buffer holds. Must be a power of 2.
+#define TELEMETRY_BUFFER_RECORDS 64
+
+// Marks the start of every record so the decoder can find them in the stream
+#define TELEMETRY_SYNC_0 0xA5
+#define TELEMETRY_SYNC_1 0x5A
+
+// Priority of the task that drains the buffer, just above idle
+#define TELEMETRY_TASK_PRIORITY (TASK_PRIORITY_LOWEST + 1)
+#define TELEMETRY_STACK_SIZE TASK_DEFAULT_STACK_SIZE
+
+/**
+ * One tick of telemetry, sent as is (little endian, no padding)
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t sync[2];
+    // Incremented for every record, including dropped ones
+    uint16_t sequence;
+    // micros() when the record was taken
+    uint32_t timestamp;
+    // Arm setpoint and calibrated potentiometer value
+    int16_t armTarget;
+    int16_t armPosition;
+    // Logical output of every motor port, index 0 is port 1
+    int8_t motors[MOTOR_PORTS];
+    // Thermal model of every motor port in percent of the trip point, capped at 255 (see motor.h)
+    uint8_t heat[MOTOR_PORTS];
+    // Main battery voltage in mV
+    uint16_t battery;
+    // Fewest free stack words of any monitored task (see stack.h)
+    uint16_t stackFree;
+    // Roughly how many bytes the heap has left (see memoryHeapFree())
+    uint16_t heapFree;
+    // Low 16 bits of the number of records dropped so far
+    uint16_t dropped;
+    // Sum of every byte before this one
+    uint8_t checksum;
+} TelemetryRecord;
+
+/**
+ * Starts the task that sends records to a stream. Call this once from initialize().
+ *
+ * @param stream The stream to send records to (stdout, uart1 or uart2)
+ */
+void telemetryInit(PROS_FILE *stream);
+
+/**
+ * Takes a record of the robot's current state and queues it. Never blocks.
+ */
+void telemetrySample();
+
+/**
+ * @return The number of records that were dropped because the buffer was full
+ */
+unsigned long telemetryDropped();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+/** @file timing.h
+ * @brief Loop timing instrumentation
+ *
+ * Named sections of code are timed with the Cortex-M3 DWT cycle counter (or micros() if
+ * TIMING_USE_DWT is 0). Each section keeps its min/avg/max and a histogram of run times in
+ * static RAM, so timing a section costs a couple of register reads. The stats are printed on
+ * request with timingPrint() or formatted for the LCD with timingLcd().
+ *
+ * Histogram bucket 0 counts times under TIMING_BUCKET_BASE microseconds, and each bucket after
+ * that covers twice the range of the one before it. The last bucket counts everything longer.
+ */
+
+#ifndef TIMING_H_
+#define TIMING_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Set to 0 to time with micros() instead of the cycle counter
+#ifndef TIMING_USE_DWT
+#define TIMING_USE_DWT 1
+#endif
+
+// Core clock of the Cortex's STM32F103, used to convert cycles to microseconds
+#define TIMING_CYCLES_PER_US 72
+
+// Number of sections that can be registered
+#define TIMING_MAX_SECTIONS 16
+
+#define TIMING_BUCKETS 8
+#define TIMING_BUCKET_BASE 16
+
+/**
+ * Statistics for one section of code. Times are in microseconds.
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[TIMING_BUCKETS];
+    // timingNow() when the section was last entered
+    uint32_t start;
+} TimingStats;
+
+/**
+ * Starts the cycle counter. Call this once from initialize().
+ */
+void timingInit();
+
+/**
+ * Registers a section to time. Registering a name that already exists returns the same section.
+ *
+ * @param name The name shown in reports. Must stay valid forever (use a string literal).
+ * @return The section ID, or -1 if there is no room for another section
+ */
+int timingRegister(const char *name);
+
+/**
+ * @return The current time in timer units (cycles, or microseconds without the DWT)
+ */
+static inline uint32_t timingNow()
+{
+#if TIMING_USE_DWT
+    return *(volatile uint32_t *)0xE0001004;
+#else
+    return micros();
+#endif
+}
+
+/**
+ * Converts a difference of timingNow() values to microseconds
+ */
+static inline uint32_t timingToMicros(uint32_t units)
+{
+#if TIMING_USE_DWT
+    return units / TIMING_CYCLES_PER_US;
+#else
+    return units;
+#endif
+}
+
+/**
+ * Adds one measurement to a section
+ *
+ * @param section The section ID from timingRegister(). Ignored if negative.
+ * @param micros The measured time in microseconds
+ */
+void timingRecord(int section, uint32_t micros);
+
+/**
+ * Marks the start of a section
+ *
+ * @param section The section ID from timingRegister(). Ignored if negative.
+ */
+void timingBegin(int section);
+
+/**
+ * Marks the end of a section and records how long it took since timingBegin()
+ *
+ * @param section The section ID from timingRegister(). Ignored if negative.
+ * @return How long the section took in microseconds
+ */
+uint32_t timingEnd(int section);
+
+/**
+ * Gets the statistics for a section
+ *
+ * @param section The section ID from timingRegister()
+ * @return The statistics, or NULL if the ID is not valid
+ */
+const TimingStats *timingGet(int section);
+
+/**
+ * @return The number of registered sections
+ */
+int timingCount();
+
+/**
+ * Clears the statistics of every section, keeping the sections registered
+ */
+void timingReset();
+
+/**
+ * Prints the statistics and histogram of every section. This is slow, so don't call it from
+ * a time critical loop.
+ *
+ * @param stream The stream to print to (stdout, uart1 or uart2)
+ */
+void timingPrint(PROS_FILE *stream);
+
+/**
+ * Formats the min/avg/max of one section as two LCD lines
+ *
+ * @param section The section ID from timingRegister()
+ * @param top Set to the first line, LCD_LINE_SIZE characters
+ * @param bottom Set to the second line, LCD_LINE_SIZE characters
+ */
+void timingLcd(int section, char *top, char *bottom);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
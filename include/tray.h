@@ -0,0 +1,97 @@
+/** @file tray.h
+ * @brief Profiled position control for the tray
+ *
+ * The tray follows a trapezoidal motion profile to its target in its own task, with a
+ * feedforward on the profile's speed and a PD loop on how far the tray is behind it. Raising
+ * the tray is fast until the last TRAY_SLOW_ZONE of the move and then slow, so a stack comes
+ * upright without tipping. The position and speed come filtered from the sensor service (see
+ * sensors.h).
+ *
+ * The limit switches (see switches.h) cut the motor at either end, and the tray task stops the
+ * profile there as well.
+ */
+
+#ifndef TRAY_H_
+#define TRAY_H_
+
+#include <API.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bounds for the tray (with calibration, the lowered state is 0)
+#define TRAY_LOWER_BOUND 0
+#define TRAY_UPPER_BOUND 3200
+
+// Default position that stands a stack upright (see config.h for the tuned one)
+#define TRAY_STACK_POSITION 2700
+
+// Period of the tray control loop in ms
+#define TRAY_PERIOD 10
+
+// Priority of the tray task, the same as the arm's
+#define TRAY_TASK_PRIORITY (TASK_PRIORITY_DEFAULT + 1)
+#define TRAY_STACK_SIZE TASK_DEFAULT_STACK_SIZE
+
+// Profile limits, in potentiometer units per second (and per second squared)
+#define TRAY_FAST_SPEED 3000
+#define TRAY_SLOW_SPEED 600
+#define TRAY_ACCELERATION 8000
+// Length of the slow end of a raise, in potentiometer units
+#define TRAY_SLOW_ZONE 800
+
+// Speed of the tray at full voltage with no load, in potentiometer units per second
+#define TRAY_FREE_SPEED 4000
+
+// Default gains (see config.h for the tuned ones)
+// Volts per unit of position behind the profile
+#define TRAY_KP Q16(0.15)
+// Volts per unit per second of profile speed, the voltage it takes to keep up with it
+#define TRAY_KV Q16(127.0 / TRAY_FREE_SPEED)
+// Volts per unit per second of speed behind the profile
+#define TRAY_KD Q16(0.01)
+
+// How close the tray has to be to a finished profile to be at its target
+#define TRAY_TOLERANCE 40
+
+/**
+ * Starts the tray control task. Call this once from initialize(), after sensorsAddAnalog() for
+ * TRAY_POTENTIOMETER.
+ */
+void trayInit();
+
+/**
+ * Starts a profiled move to a position. This is safe to call from any task, and calling it
+ * again with the same target carries on with the move.
+ *
+ * @param target The calibrated potentiometer value to move to, clamped to the tray bounds
+ */
+void traySetTarget(int target);
+
+/**
+ * Brings the tray to a stop as soon as the profile's acceleration allows and holds it there
+ */
+void trayHold();
+
+/**
+ * @return The position the tray is moving to
+ */
+int trayGetTarget();
+
+/**
+ * @return The filtered, calibrated potentiometer value the tray task last used
+ */
+int trayGetPosition();
+
+/**
+ * @return true once the profile has finished and the tray is within TRAY_TOLERANCE of it
+ */
+bool trayAtTarget();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,529 @@
+/** @file api.c
+ * @brief Simulated PROS API
+ *
+ * The hardware functions read and write simHardware, and the controller ones read simInputs.
+ * The task functions are in kernel.c. Flash files are kept in memory, so every run starts with
+ * an empty file system and the default config.
+ */
+
+#include "sim.h"
+#include "host.h"
+#include "led.h"
+
+// Flash files and how big each may get, enough for a full recording (see replay.h)
+#define SIM_FILES 8
+#define SIM_FILE_SIZE 16384
+
+// Streams for open files start after the serial ports
+#define SIM_FILE_STREAM 16
+
+SimHardware simHardware;
+SimInputs simInputs;
+volatile bool simEnabled = false;
+
+// Stands in for the heap between the memory.c linker symbols, which the sim target in the
+// Makefile points at either end of it
+#define SIM_RAM_SIZE 0x10000
+char simRam[SIM_RAM_SIZE];
+
+/**
+ * A file in the simulated flash
+ */
+typedef struct
+{
+    char name[9];
+    bool used;
+    uint8_t data[SIM_FILE_SIZE];
+    size_t size;
+    // Read or write position while open
+    size_t position;
+    bool open;
+} SimFile;
+
+static SimFile files[SIM_FILES];
+
+// Analog calibration offsets from analogCalibrate()
+static int analogOffsets[SIM_ANALOG_PORTS + 1];
+
+// Pin change interrupts, and the level each pin was last seen at
+static InterruptHandler handlers[SIM_DIGITAL_PORTS + 1];
+static unsigned char handlerEdges[SIM_DIGITAL_PORTS + 1];
+static bool lastLevels[SIM_DIGITAL_PORTS + 1];
+
+/**
+ * An encoder or gyro handle: which port it reads and its zero
+ */
+typedef struct
+{
+    unsigned char port;
+    int offset;
+} SimSensor;
+
+static SimSensor encoders[SIM_DIGITAL_PORTS + 1];
+static SimSensor gyro;
+
+// Lines on the LCD, for the report
+char simLcd[2][17];
+
+bool isEnabled()
+{
+    return simEnabled;
+}
+
+/*
+ * Motors
+ */
+
+void motorSet(unsigned char channel, int speed)
+{
+    if(channel >= 1 && channel <= SIM_MOTOR_PORTS)
+    {
+        simHardware.motors[channel] = speed > 127 ? 127 : speed < -127 ? -127 : speed;
+    }
+}
+
+int motorGet(unsigned char channel)
+{
+    return channel >= 1 && channel <= SIM_MOTOR_PORTS ? simHardware.motors[channel] : 0;
+}
+
+void motorStop(unsigned char channel)
+{
+    motorSet(channel, 0);
+}
+
+void motorStopAll()
+{
+    for(unsigned char channel = 1; channel <= SIM_MOTOR_PORTS; channel++)
+    {
+        motorStop(channel);
+    }
+}
+
+unsigned int powerLevelMain()
+{
+    return simHardware.battery;
+}
+
+unsigned int powerLevelBackup()
+{
+    return 9000;
+}
+
+/*
+ * Sensors
+ */
+
+int analogRead(unsigned char channel)
+{
+    return channel >= 1 && channel <= SIM_ANALOG_PORTS ? simHardware.analog[channel] : 0;
+}
+
+int analogCalibrate(unsigned char channel)
+{
+    if(channel < 1 || channel > SIM_ANALOG_PORTS)
+    {
+        return 0;
+    }
+    analogOffsets[channel] = analogRead(channel);
+    return analogOffsets[channel];
+}
+
+int analogReadCalibrated(unsigned char channel)
+{
+    return channel >= 1 && channel <= SIM_ANALOG_PORTS ?
+        analogRead(channel) - analogOffsets[channel] : 0;
+}
+
+int analogReadCalibratedHR(unsigned char channel)
+{
+    return analogReadCalibrated(channel) * 16;
+}
+
+void pinMode(unsigned char pin, unsigned char mode)
+{
+}
+
+bool digitalRead(unsigned char pin)
+{
+    return pin >= 1 && pin <= SIM_DIGITAL_PORTS ? simHardware.digital[pin] : true;
+}
+
+void digitalWrite(unsigned char pin, bool value)
+{
+}
+
+void ioSetInterrupt(unsigned char pin, unsigned char edges, InterruptHandler handler)
+{
+    if(pin >= 1 && pin <= SIM_DIGITAL_PORTS)
+    {
+        lastLevels[pin] = simHardware.digital[pin];
+        handlerEdges[pin] = edges;
+        handlers[pin] = handler;
+    }
+}
+
+void ioClearInterrupt(unsigned char pin)
+{
+    if(pin >= 1 && pin <= SIM_DIGITAL_PORTS)
+    {
+        handlers[pin] = NULL;
+    }
+}
+
+void simCheckInterrupts()
+{
+    for(unsigned char pin = 1; pin <= SIM_DIGITAL_PORTS; pin++)
+    {
+        bool level = simHardware.digital[pin];
+        if(handlers[pin] == NULL || level == lastLevels[pin])
+        {
+            continue;
+        }
+        lastLevels[pin] = level;
+        if(handlerEdges[pin] & (level ? INTERRUPT_EDGE_RISING : INTERRUPT_EDGE_FALLING))
+        {
+            handlers[pin](pin);
+        }
+    }
+}
+
+Encoder encoderInit(unsigned char portTop, unsigned char portBottom, bool reverse)
+{
+    if(portTop < 1 || portTop > SIM_DIGITAL_PORTS)
+    {
+        return NULL;
+    }
+    // The physics counts each encoder the way it is wired on the robot, reverse included
+    encoders[portTop].port = portTop;
+    encoders[portTop].offset = simHardware.encoders[portTop];
+    return &encoders[portTop];
+}
+
+int encoderGet(Encoder enc)
+{
+    SimSensor *encoder = enc;
+    return encoder != NULL ? simHardware.encoders[encoder->port] - encoder->offset : 0;
+}
+
+void encoderReset(Encoder enc)
+{
+    SimSensor *encoder = enc;
+    if(encoder != NULL)
+    {
+        encoder->offset = simHardware.encoders[encoder->port];
+    }
+}
+
+Gyro gyroInit(unsigned char port, unsigned short multiplier)
+{
+    gyro.port = port;
+    gyro.offset = simHardware.gyro;
+    return &gyro;
+}
+
+int gyroGet(Gyro handle)
+{
+    SimSensor *sensor = handle;
+    return sensor != NULL ? simHardware.gyro - sensor->offset : 0;
+}
+
+void gyroReset(Gyro handle)
+{
+    SimSensor *sensor = handle;
+    if(sensor != NULL)
+    {
+        sensor->offset = simHardware.gyro;
+    }
+}
+
+unsigned int imeInitializeAll()
+{
+    return 0;
+}
+
+bool imeGet(unsigned char address, int *value)
+{
+    return false;
+}
+
+/*
+ * Controller and LCD
+ */
+
+int joystickGetAnalog(unsigned char joystick, unsigned char axis)
+{
+    return joystick == 1 && axis >= 1 && axis <= 4 ? simInputs.axes[axis] : 0;
+}
+
+bool joystickGetDigital(unsigned char joystick, unsigned char buttonGroup,
+    unsigned char button)
+{
+    return joystick == 1 && buttonGroup >= 5 && buttonGroup <= 8 &&
+        (simInputs.buttons[buttonGroup] & button) != 0;
+}
+
+void lcdInit(PROS_FILE *lcdPort)
+{
+}
+
+void lcdClear(PROS_FILE *lcdPort)
+{
+    simLcd[0][0] = '\0';
+    simLcd[1][0] = '\0';
+}
+
+void lcdSetBacklight(PROS_FILE *lcdPort, bool backlight)
+{
+}
+
+void lcdSetText(PROS_FILE *lcdPort, unsigned char line, const char *buffer)
+{
+    if(line == 1 || line == 2)
+    {
+        snprintf(simLcd[line - 1], sizeof(simLcd[0]), "%s", buffer);
+    }
+}
+
+unsigned int lcdReadButtons(PROS_FILE *lcdPort)
+{
+    return simInputs.lcdButtons;
+}
+
+/*
+ * Streams and files
+ */
+
+/**
+ * @return The open file a stream refers to, or NULL if it isn't one
+ */
+static SimFile *streamFile(PROS_FILE *stream)
+{
+    intptr_t index = (intptr_t)stream - SIM_FILE_STREAM;
+    return index >= 0 && index < SIM_FILES && files[index].open ? &files[index] : NULL;
+}
+
+/**
+ * @return true if two file names match, to the 8 characters PROS keeps
+ */
+static bool sameName(const char *a, const char *b)
+{
+    for(int i = 0; i < 8; i++)
+    {
+        if(a[i] != b[i])
+        {
+            return false;
+        }
+        if(a[i] == '\0')
+        {
+            return true;
+        }
+    }
+    return true;
+}
+
+PROS_FILE *fopen(const char *file, const char *mode)
+{
+    SimFile *found = NULL;
+    for(int i = 0; i < SIM_FILES && found == NULL; i++)
+    {
+        if(files[i].used && sameName(files[i].name, file))
+        {
+            found = &files[i];
+        }
+    }
+
+    if(mode[0] == 'w')
+    {
+        for(int i = 0; i < SIM_FILES && found == NULL; i++)
+        {
+            if(!files[i].used)
+            {
+                found = &files[i];
+                found->used = true;
+                snprintf(found->name, sizeof(found->name), "%s", file);
+            }
+        }
+        if(found != NULL)
+        {
+            found->size = 0;
+        }
+    }
+
+    if(found == NULL || found->open)
+    {
+        return NULL;
+    }
+    found->open = true;
+    found->position = 0;
+    return (PROS_FILE *)(intptr_t)(SIM_FILE_STREAM + (found - files));
+}
+
+bool simFlashLoad(const char *name, const char *path)
+{
+    static uint8_t data[SIM_FILE_SIZE];
+    long size = hostReadFile(path, data, sizeof(data));
+    PROS_FILE *stream = size < 0 ? NULL : fopen(name, "w");
+    if(stream == NULL)
+    {
+        return false;
+    }
+    fwrite(data, 1, (size_t)size, stream);
+    fclose(stream);
+    return true;
+}
+
+bool simFlashSave(const char *name, const char *path)
+{
+    for(int i = 0; i < SIM_FILES; i++)
+    {
+        if(files[i].used && sameName(files[i].name, name))
+        {
+            return hostWriteFile(path, files[i].data, files[i].size);
+        }
+    }
+    return false;
+}
+
+void fclose(PROS_FILE *stream)
+{
+    SimFile *file = streamFile(stream);
+    if(file != NULL)
+    {
+        file->open = false;
+    }
+}
+
+size_t fread(void *ptr, size_t size, size_t count, PROS_FILE *stream)
+{
+    SimFile *file = streamFile(stream);
+    if(file == NULL || size == 0)
+    {
+        return 0;
+    }
+
+    size_t items = (file->size - file->position) / size;
+    items = items < count ? items : count;
+    uint8_t *bytes = ptr;
+    for(size_t i = 0; i < items * size; i++)
+    {
+        bytes[i] = file->data[file->position++];
+    }
+    return items;
+}
+
+size_t fwrite(const void *ptr, size_t size, size_t count, PROS_FILE *stream)
+{
+    if(stream == stdout)
+    {
+        hostSerialWrite(ptr, size * count);
+        return count;
+    }
+
+    SimFile *file = streamFile(stream);
+    if(file == NULL || size == 0)
+    {
+        return 0;
+    }
+
+    size_t items = (SIM_FILE_SIZE - file->position) / size;
+    items = items < count ? items : count;
+    const uint8_t *bytes = ptr;
+    for(size_t i = 0; i < items * size; i++)
+    {
+        file->data[file->position++] = bytes[i];
+    }
+    if(file->position > file->size)
+    {
+        file->size = file->position;
+    }
+    return items;
+}
+
+char *fgets(char *str, int num, PROS_FILE *stream)
+{
+    // Nothing is ever typed into the simulated debug terminal
+    SimFile *file = streamFile(stream);
+    if(file == NULL || num < 1 || file->position >= file->size)
+    {
+        return NULL;
+    }
+
+    int length = 0;
+    while(length < num - 1 && file->position < file->size)
+    {
+        char c = (char)file->data[file->position++];
+        str[length++] = c;
+        if(c == '\n')
+        {
+            break;
+        }
+    }
+    str[length] = '\0';
+    return str;
+}
+
+int fflush(PROS_FILE *stream)
+{
+    return 0;
+}
+
+int fprintf(PROS_FILE *stream, const char *formatString, ...)
+{
+    // Only the debug terminal is kept, the UARTs go nowhere
+    if(stream != stdout)
+    {
+        return 0;
+    }
+    va_list args;
+    va_start(args, formatString);
+    hostSerialPrint(formatString, args);
+    va_end(args);
+    return 0;
+}
+
+int printf(const char *formatString, ...)
+{
+    va_list args;
+    va_start(args, formatString);
+    hostSerialPrint(formatString, args);
+    va_end(args);
+    return 0;
+}
+
+int fputs(const char *string, PROS_FILE *stream)
+{
+    return fprintf(stream, "%s", string);
+}
+
+void print(const char *string)
+{
+    printf("%s", string);
+}
+
+/*
+ * The LED strip driver writes to the timer and DMA registers, so the simulation has a strip
+ * that is always ready and never lights up
+ */
+
+void ledInit()
+{
+}
+
+void ledSetPixel(unsigned int index, uint8_t red, uint8_t green, uint8_t blue)
+{
+}
+
+void ledFill(uint8_t red, uint8_t green, uint8_t blue)
+{
+}
+
+bool ledShow()
+{
+    return true;
+}
+
+bool ledBusy()
+{
+    return false;
+}
@@ -0,0 +1,118 @@
+/** @file host.c
+ * @brief The simulation's access to the host C library
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host.h"
+
+// Where the robot's stdout goes, NULL to throw it away
+static FILE *serial = NULL;
+
+bool hostOpenSerial(const char *path)
+{
+    serial = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+    return serial != NULL;
+}
+
+void hostSerialWrite(const void *data, size_t size)
+{
+    if(serial != NULL)
+    {
+        fwrite(data, 1, size, serial);
+    }
+}
+
+void hostSerialPrint(const char *format, va_list args)
+{
+    if(serial != NULL)
+    {
+        vfprintf(serial, format, args);
+    }
+}
+
+void hostPrint(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void hostError(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+long hostReadFile(const char *path, void *data, size_t maxSize)
+{
+    FILE *file = fopen(path, "rb");
+    if(file == NULL)
+    {
+        return -1;
+    }
+    size_t size = fread(data, 1, maxSize, file);
+    bool tooBig = fgetc(file) != EOF;
+    fclose(file);
+    return tooBig ? -1 : (long)size;
+}
+
+bool hostWriteFile(const char *path, const void *data, size_t size)
+{
+    FILE *file = fopen(path, "wb");
+    if(file == NULL)
+    {
+        return false;
+    }
+    bool written = fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && written;
+}
+
+int hostReadScript(const char *path, HostScriptLine *lines, int maxLines)
+{
+    FILE *file = fopen(path, "r");
+    if(file == NULL)
+    {
+        hostError("%s: can't open\n", path);
+        return -1;
+    }
+
+    char text[128];
+    int count = 0;
+    int lineNumber = 0;
+    while(fgets(text, sizeof(text), file) != NULL)
+    {
+        lineNumber++;
+        char *comment = strchr(text, '#');
+        if(comment != NULL)
+        {
+            *comment = '\0';
+        }
+
+        char input[32];
+        unsigned int time;
+        int value;
+        int fields = sscanf(text, "%u %31s %d", &time, input, &value);
+        if(fields <= 0)
+        {
+            continue;
+        }
+        if(fields != 3 || strlen(input) >= HOST_INPUT_LENGTH || count >= maxLines)
+        {
+            hostError("%s:%d: expected \"<ms> <input> <value>\"\n", path, lineNumber);
+            fclose(file);
+            return -1;
+        }
+
+        lines[count].time = time;
+        strcpy(lines[count].input, input);
+        lines[count].value = value;
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
@@ -0,0 +1,95 @@
+/** @file host.h
+ * @brief The simulation's access to the host C library
+ *
+ * host.c is the only simulation source built without rename.h, so it is the only one that can
+ * use the host's stdio. Nothing here uses the PROS types.
+ */
+
+#ifndef SIM_HOST_H_
+#define SIM_HOST_H_
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest input name in a script line
+#define HOST_INPUT_LENGTH 8
+
+/**
+ * One line of a joystick script: at time ms, set input to value
+ */
+typedef struct
+{
+    uint32_t time;
+    char input[HOST_INPUT_LENGTH];
+    int value;
+} HostScriptLine;
+
+/**
+ * Sends the robot's serial output (the PROS stdout) to a file instead of throwing it away
+ *
+ * @param path The file to write, or "-" for the host's stdout
+ * @return true if the file could be opened
+ */
+bool hostOpenSerial(const char *path);
+
+/**
+ * Writes the robot's serial output
+ */
+void hostSerialWrite(const void *data, size_t size);
+
+/**
+ * Formats the robot's serial output
+ */
+void hostSerialPrint(const char *format, va_list args);
+
+/**
+ * Prints the simulation's own output (traces and the report) to the host's stdout
+ */
+void hostPrint(const char *format, ...) __attribute__((format(__printf__, 1, 2)));
+
+/**
+ * Prints an error to the host's stderr
+ */
+void hostError(const char *format, ...) __attribute__((format(__printf__, 1, 2)));
+
+/**
+ * Reads a whole file
+ *
+ * @param path The file to read
+ * @param data Set to the contents
+ * @param maxSize Size of data
+ * @return The number of bytes read, or -1 if the file couldn't be read or is bigger than maxSize
+ */
+long hostReadFile(const char *path, void *data, size_t maxSize);
+
+/**
+ * Writes a whole file
+ *
+ * @param path The file to write
+ * @param data The contents
+ * @param size Size of data
+ * @return true if it was written
+ */
+bool hostWriteFile(const char *path, const void *data, size_t size);
+
+/**
+ * Reads a joystick script. Each line is "<ms> <input> <value>", and # starts a comment.
+ *
+ * @param path The script file
+ * @param lines Set to the lines, in file order
+ * @param maxLines Size of lines
+ * @return The number of lines read, or -1 if the file couldn't be read or has a bad line
+ */
+int hostReadScript(const char *path, HostScriptLine *lines, int maxLines);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,275 @@
+/** @file kernel.c
+ * @brief Virtual time task scheduler
+ *
+ * Every task is a host thread, but only the current one runs: the rest wait on their own
+ * condition variable, and the kernel lock is held by whichever task is running. A task only
+ * gives up the processor when it blocks (delay(), taskDelayUntil() or waiting on a mutex),
+ * which is then handed to the highest priority task that is due, round robin between equal
+ * priorities. When nothing is due, the clock jumps to the next wake time, stepping the physics
+ * on the way.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include "sim.h"
+
+/**
+ * A simulated task
+ */
+typedef struct SimTask
+{
+    pthread_t thread;
+    pthread_cond_t turn;
+    TaskCode code;
+    void *parameters;
+    unsigned int priority;
+    // Virtual time the task can run again, UINT64_MAX once it has returned
+    uint64_t wakeTime;
+    // When it last got the processor, for round robin
+    unsigned long lastRun;
+    // The stand in for its stack, see taskCreate()
+    void *stack;
+    struct SimTask *next;
+} SimTask;
+
+/**
+ * A simulated mutex, which can be taken again by the task holding it
+ */
+typedef struct
+{
+    SimTask *owner;
+    unsigned int count;
+} SimMutex;
+
+static pthread_mutex_t kernelLock = PTHREAD_MUTEX_INITIALIZER;
+static SimTask *tasks = NULL;
+static SimTask *current = NULL;
+static unsigned long runs = 0;
+
+static uint64_t now = 0;
+static uint64_t stopTime = UINT64_MAX;
+
+uint64_t simNow()
+{
+    return now;
+}
+
+/**
+ * @return The task that should run now, or NULL if none are due
+ */
+static SimTask *pick()
+{
+    SimTask *best = NULL;
+    for(SimTask *task = tasks; task != NULL; task = task->next)
+    {
+        if(task->wakeTime <= now && (best == NULL || task->priority > best->priority ||
+            (task->priority == best->priority && task->lastRun < best->lastRun)))
+        {
+            best = task;
+        }
+    }
+    return best;
+}
+
+/**
+ * Moves the clock on to the next wake time, stepping the world every SIM_STEP on the way
+ */
+static void advance()
+{
+    uint64_t next = UINT64_MAX;
+    for(SimTask *task = tasks; task != NULL; task = task->next)
+    {
+        if(task->wakeTime < next)
+        {
+            next = task->wakeTime;
+        }
+    }
+
+    while(now < next)
+    {
+        uint64_t step = SIM_STEP - now % SIM_STEP;
+        if(now + step > next)
+        {
+            step = next - now;
+        }
+        now += step;
+
+        if(now % SIM_STEP == 0)
+        {
+            scriptUpdate((unsigned long)(now / 1000));
+            physicsStep();
+            simCheckInterrupts();
+        }
+        if(now >= stopTime)
+        {
+            simFinish();
+        }
+    }
+}
+
+/**
+ * Hands the processor to the next task and waits until it comes back. Called with the kernel
+ * lock held.
+ *
+ * @param self The calling task, or NULL for the thread starting the kernel
+ */
+static void schedule(SimTask *self)
+{
+    SimTask *next;
+    while((next = pick()) == NULL)
+    {
+        advance();
+    }
+
+    next->lastRun = ++runs;
+    current = next;
+    if(next != self)
+    {
+        pthread_cond_signal(&next->turn);
+        while(self != NULL && current != self)
+        {
+            pthread_cond_wait(&self->turn, &kernelLock);
+        }
+    }
+}
+
+/**
+ * Runs a task's code once it first gets the processor
+ */
+static void *taskThread(void *argument)
+{
+    SimTask *task = argument;
+    pthread_mutex_lock(&kernelLock);
+    while(current != task)
+    {
+        pthread_cond_wait(&task->turn, &kernelLock);
+    }
+
+    task->code(task->parameters);
+
+    // A task that returns is gone for good
+    task->wakeTime = UINT64_MAX;
+    schedule(task);
+    return NULL;
+}
+
+void simKernelRun(uint64_t endTime)
+{
+    stopTime = endTime;
+    pthread_mutex_lock(&kernelLock);
+    schedule(NULL);
+
+    // Only simFinish() ends the simulation
+    pthread_cond_t never = PTHREAD_COND_INITIALIZER;
+    while(1)
+    {
+        pthread_cond_wait(&never, &kernelLock);
+    }
+}
+
+TaskHandle taskCreate(TaskCode taskCode, const unsigned int stackDepth, void *parameters,
+    const unsigned int priority)
+{
+    SimTask *task = calloc(1, sizeof(SimTask));
+    if(task == NULL)
+    {
+        return NULL;
+    }
+    task->code = taskCode;
+    task->parameters = parameters;
+    task->priority = priority < TASK_MAX_PRIORITIES ? priority : TASK_PRIORITY_HIGHEST;
+    task->wakeTime = now;
+    pthread_cond_init(&task->turn, NULL);
+
+    // The kernel allocates the stack from the heap, which is what the stack monitor watches
+    // for. The task really runs on its thread's stack, so this one stays painted.
+    task->stack = malloc(stackDepth * sizeof(uint32_t));
+
+    task->next = tasks;
+    tasks = task;
+    if(pthread_create(&task->thread, NULL, taskThread, task) != 0)
+    {
+        tasks = task->next;
+        free(task);
+        return NULL;
+    }
+    return task;
+}
+
+void taskDelay(const unsigned long msToDelay)
+{
+    current->wakeTime = now + (uint64_t)msToDelay * 1000;
+    schedule(current);
+}
+
+void delay(const unsigned long time)
+{
+    taskDelay(time);
+}
+
+void wait(const unsigned long time)
+{
+    taskDelay(time);
+}
+
+void taskDelayUntil(unsigned long *previousWakeTime, const unsigned long cycleTime)
+{
+    *previousWakeTime += cycleTime;
+    uint64_t wakeTime = (uint64_t)*previousWakeTime * 1000;
+    // Late tasks only let the others at the same priority have a turn
+    current->wakeTime = wakeTime > now ? wakeTime : now;
+    schedule(current);
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(now / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)now;
+}
+
+Mutex mutexCreate()
+{
+    return calloc(1, sizeof(SimMutex));
+}
+
+bool mutexTake(Mutex mutex, const unsigned long blockTime)
+{
+    SimMutex *simMutex = mutex;
+    if(simMutex == NULL)
+    {
+        return false;
+    }
+
+    unsigned long waited = 0;
+    while(simMutex->owner != NULL && simMutex->owner != current)
+    {
+        // blockTime is unsigned, so -1 waits forever
+        if(waited >= blockTime)
+        {
+            return false;
+        }
+        taskDelay(1);
+        waited++;
+    }
+    simMutex->owner = current;
+    simMutex->count++;
+    return true;
+}
+
+bool mutexGive(Mutex mutex)
+{
+    SimMutex *simMutex = mutex;
+    if(simMutex == NULL || simMutex->owner != current)
+    {
+        return false;
+    }
+    if(--simMutex->count == 0)
+    {
+        simMutex->owner = NULL;
+    }
+    return true;
+}
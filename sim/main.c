@@ -0,0 +1,192 @@
+/** @file main.c
+ * @brief Runs the simulation
+ *
+ * sim [-a] [-s script] [-r recording] [-w recording] [-t seconds] [-b mV] [-o file] [-v]
+ *
+ * -a runs autonomous() instead of operatorControl(), -s plays a joystick script (see script.c),
+ * -t sets how long to run for (15 s for autonomous, otherwise 105 s or until the script ends),
+ * -b sets the starting battery voltage, -o sends the robot's serial output to a file ("-" for
+ * the terminal) and -v prints where the robot is every 100 ms. A report of where everything
+ * ended up is printed at the end.
+ *
+ * -r replays a recording (see replay.h) as the autonomous routine. A recording from the robot's
+ * console "replay" command can be turned back into a file with "xxd -r -p". -w records the run
+ * and writes the recording to a file at the end.
+ */
+
+#include <stdlib.h>
+#include "sim.h"
+#include "host.h"
+#include "main.h"
+#include "config.h"
+#include "path.h"
+#include "replay.h"
+
+// Default lengths of the match periods in seconds
+#define SIM_AUTONOMOUS_TIME 15
+#define SIM_DRIVER_TIME 105
+
+// How often -v prints, in ms
+#define SIM_TRACE_PERIOD 100
+
+// How long the replay writer gets to finish the recording after the robot is disabled, in ms
+#define SIM_RECORD_MARGIN (REPLAY_DRAIN_PERIOD * 3)
+
+static bool runAutonomous;
+static bool runReplay;
+static bool trace;
+static const char *recordPath = NULL;
+static unsigned long endTime;
+
+/**
+ * Prints the robot's position every SIM_TRACE_PERIOD
+ */
+static void traceTask(void *ignore)
+{
+    unsigned long wakeTime = millis();
+    physicsPrint(true);
+    while(true)
+    {
+        taskDelayUntil(&wakeTime, SIM_TRACE_PERIOD);
+        physicsPrint(false);
+    }
+}
+
+/**
+ * Disables the robot at the end, so the replay writer finishes the recording the way it would
+ * on the field, and then saves it
+ */
+static void recordTask(void *ignore)
+{
+    taskDelay(endTime - millis());
+    simEnabled = false;
+    taskDelay(SIM_RECORD_MARGIN);
+    if(!simFlashSave(REPLAY_FILE, recordPath))
+    {
+        hostError("%s: can't save the recording\n", recordPath);
+        exit(1);
+    }
+    hostPrint("recording %u bytes\n", (unsigned int)replaySize());
+    simFinish();
+}
+
+/**
+ * Stands in for the PROS startup: runs the robot code the way the competition switch would
+ */
+static void mainTask(void *ignore)
+{
+    initializeIO();
+    initialize();
+    if(runReplay)
+    {
+        config.autonSelection = (int32_t)autonPathCount;
+    }
+    if(recordPath)
+    {
+        replayArm(true);
+        taskCreate(recordTask, TASK_MINIMAL_STACK_SIZE, NULL, TASK_PRIORITY_HIGHEST);
+    }
+    simEnabled = true;
+    if(trace)
+    {
+        taskCreate(traceTask, TASK_MINIMAL_STACK_SIZE, NULL, TASK_PRIORITY_HIGHEST);
+    }
+    if(runAutonomous)
+    {
+        autonomous();
+        simFinish();
+    }
+    operatorControl();
+}
+
+void simFinish()
+{
+    hostPrint("time %.3f s\n", (double)simNow() / 1e6);
+    hostPrint("pose x %.2f in, y %.2f in, heading %.1f deg\n", simHardware.x, simHardware.y,
+        simHardware.heading);
+    hostPrint("arm pot %d, tray pot %d\n", simHardware.analog[ARM_POTENTIOMETER],
+        simHardware.analog[TRAY_POTENTIOMETER]);
+    hostPrint("battery %u mV\n", simHardware.battery);
+    hostPrint("lcd [%s] [%s]\n", simLcd[0], simLcd[1]);
+    exit(0);
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = 0;
+    unsigned int battery = 8000;
+    const char *script = NULL;
+    const char *serial = NULL;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const char *option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(option[0] == '-' && option[1] == 'a' && !option[2])
+        {
+            runAutonomous = true;
+        }
+        else if(option[0] == '-' && option[1] == 'v' && !option[2])
+        {
+            trace = true;
+        }
+        else if(option[0] == '-' && option[1] == 's' && !option[2] && hasValue)
+        {
+            script = argv[++i];
+        }
+        else if(option[0] == '-' && option[1] == 'r' && !option[2] && hasValue)
+        {
+            if(!simFlashLoad(REPLAY_FILE, argv[++i]))
+            {
+                hostError("%s: can't load the recording\n", argv[i]);
+                return 1;
+            }
+            runAutonomous = runReplay = true;
+        }
+        else if(option[0] == '-' && option[1] == 'w' && !option[2] && hasValue)
+        {
+            recordPath = argv[++i];
+        }
+        else if(option[0] == '-' && option[1] == 't' && !option[2] && hasValue)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if(option[0] == '-' && option[1] == 'b' && !option[2] && hasValue)
+        {
+            battery = (unsigned int)atoi(argv[++i]);
+        }
+        else if(option[0] == '-' && option[1] == 'o' && !option[2] && hasValue)
+        {
+            serial = argv[++i];
+        }
+        else
+        {
+            hostError("usage: %s [-a] [-s script] [-r recording] [-w recording] [-t seconds] "
+                "[-b mV] [-o file] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if(script && !scriptLoad(script))
+    {
+        hostError("%s: can't load the script\n", script);
+        return 1;
+    }
+    if(serial && !hostOpenSerial(serial))
+    {
+        hostError("%s: can't open the serial output\n", serial);
+        return 1;
+    }
+    if(seconds <= 0)
+    {
+        seconds = runReplay ? SIM_DRIVER_TIME : runAutonomous ? SIM_AUTONOMOUS_TIME :
+            scriptLength() ? scriptLength() / 1000.0 + 1 : SIM_DRIVER_TIME;
+    }
+
+    // When recording, recordTask() ends the run instead of the kernel
+    endTime = (unsigned long)(seconds * 1000);
+    physicsInit(battery);
+    taskCreate(mainTask, TASK_DEFAULT_STACK_SIZE, NULL, TASK_PRIORITY_DEFAULT);
+    simKernelRun((uint64_t)(endTime + (recordPath ? SIM_RECORD_MARGIN * 2 : 0)) * 1000);
+    return 0;
+}
@@ -0,0 +1,194 @@
+/** @file physics.c
+ * @brief Model of the drive, arm and tray
+ *
+ * Each mechanism is a first order motor model: a command (after the battery) settles to a
+ * speed in proportion to the voltage, with a time constant for the mass and a deadband for
+ * static friction. The arm and tray feel gravity as a voltage they need just to hold still,
+ * and both stop dead at the ends of their travel. The numbers are rough guesses at the real
+ * robot, not measurements, and are kept apart from the firmware's own constants so the two
+ * can disagree the way the real robot does.
+ */
+
+#include <math.h>
+#include "sim.h"
+#include "host.h"
+#include "main.h"
+
+#define PI 3.14159265358979
+
+// Voltage the free speeds are given at, in mV
+#define REFERENCE_VOLTAGE 7800.0
+
+// Command fraction that static friction soaks up
+#define DEADBAND 0.04
+
+// 4" wheels with 360 tick shaft encoders, free speed in inches per second
+#define WHEEL_DIAMETER 4.0
+#define ENCODER_TICKS 360.0
+#define TRACK_WIDTH 14.0
+#define DRIVE_FREE_SPEED 21.0
+#define DRIVE_TIME_CONSTANT 0.15
+
+// The arm swings from 20 degrees below horizontal to 90 above over its travel, in pot units
+#define ARM_TRAVEL 4000.0
+#define ARM_REST_RAW 300
+#define ARM_FREE_SPEED 5000.0
+#define ARM_TIME_CONSTANT 0.08
+// Command fraction it takes to hold the arm horizontal
+#define ARM_GRAVITY 0.2
+
+#define TRAY_TRAVEL 3300.0
+#define TRAY_REST_RAW 500
+#define TRAY_FREE_SPEED 4000.0
+#define TRAY_TIME_CONSTANT 0.1
+// Command fraction it takes to hold the lowered tray, less as it stands up
+#define TRAY_GRAVITY 0.08
+// How close to the ends the limit switches close, in pot units
+#define TRAY_SWITCH_TRAVEL 10.0
+
+// Battery voltage lost per second of running, and under full load on one motor, in mV
+#define BATTERY_DRAIN 4.0
+#define BATTERY_SAG_PER_MOTOR 100.0
+
+// Spread of the potentiometer noise, in counts either side
+#define POT_NOISE 2
+
+/**
+ * A mechanism driven by a motor
+ */
+typedef struct
+{
+    double position;
+    double speed;
+} Axis;
+
+static Axis left;
+static Axis right;
+static Axis arm;
+static Axis tray;
+
+static double restingBattery;
+static uint32_t noiseState = 12345;
+
+/**
+ * @return Potentiometer noise, from a fixed seed so every run is the same
+ */
+static int noise()
+{
+    noiseState = noiseState * 1103515245u + 12345u;
+    return (int)((noiseState >> 16) % (2 * POT_NOISE + 1)) - POT_NOISE;
+}
+
+/**
+ * @return The voltage fraction a motor gets from a command, 0 while disabled
+ */
+static double voltage(int command)
+{
+    if(!simEnabled)
+    {
+        return 0;
+    }
+    return command / 127.0 * simHardware.battery / REFERENCE_VOLTAGE;
+}
+
+/**
+ * Steps a mechanism's speed towards where its voltage would settle, and its position on
+ */
+static void stepAxis(Axis *axis, double drive, double freeSpeed, double timeConstant,
+    double dt)
+{
+    if(fabs(drive) < DEADBAND && fabs(axis->speed) < freeSpeed * 0.01)
+    {
+        drive = 0;
+    }
+    axis->speed += (drive * freeSpeed - axis->speed) * dt / timeConstant;
+    axis->position += axis->speed * dt;
+}
+
+/**
+ * Stops a mechanism at the ends of its travel
+ */
+static void hardStops(Axis *axis, double travel)
+{
+    if(axis->position < 0 || axis->position > travel)
+    {
+        axis->position = axis->position < 0 ? 0 : travel;
+        axis->speed = 0;
+    }
+}
+
+void physicsInit(unsigned int battery)
+{
+    restingBattery = battery;
+    simHardware = (SimHardware) {.battery = battery};
+    for(int pin = 1; pin <= SIM_DIGITAL_PORTS; pin++)
+    {
+        // Pulled up
+        simHardware.digital[pin] = true;
+    }
+    left = right = arm = tray = (Axis) {0, 0};
+    physicsStep();
+}
+
+void physicsStep()
+{
+    const double dt = SIM_STEP / 1e6;
+    int *motors = simHardware.motors;
+
+    // The right side motors face the other way
+    double leftDrive = voltage(motors[LEFT_MOTOR_FRONT] + motors[LEFT_MOTOR_BACK]) / 2;
+    double rightDrive = -voltage(motors[RIGHT_MOTOR_FRONT] + motors[RIGHT_MOTOR_BACK]) / 2;
+    stepAxis(&left, leftDrive, DRIVE_FREE_SPEED, DRIVE_TIME_CONSTANT, dt);
+    stepAxis(&right, rightDrive, DRIVE_FREE_SPEED, DRIVE_TIME_CONSTANT, dt);
+
+    double speed = (left.speed + right.speed) / 2;
+    double turn = (right.speed - left.speed) / TRACK_WIDTH;
+    double heading = simHardware.heading * PI / 180 + turn * dt / 2;
+    simHardware.x += speed * cos(heading) * dt;
+    simHardware.y += speed * sin(heading) * dt;
+    simHardware.heading += turn * dt * 180 / PI;
+
+    const double ticksPerInch = ENCODER_TICKS / (PI * WHEEL_DIAMETER);
+    simHardware.encoders[LEFT_ENCODER_TOP] = (int)lround(left.position * ticksPerInch);
+    simHardware.encoders[RIGHT_ENCODER_TOP] = (int)lround(right.position * ticksPerInch);
+    simHardware.gyro = (int)lround(simHardware.heading);
+
+    // Positive voltage lowers the arm
+    double angle = (-20 + arm.position / ARM_TRAVEL * 110) * PI / 180;
+    double armDrive = -voltage(motors[RIGHT_ARM] + motors[LEFT_ARM]) / 2;
+    stepAxis(&arm, armDrive - ARM_GRAVITY * cos(angle), ARM_FREE_SPEED, ARM_TIME_CONSTANT, dt);
+    hardStops(&arm, ARM_TRAVEL);
+    simHardware.analog[ARM_POTENTIOMETER] = ARM_REST_RAW + (int)lround(arm.position) + noise();
+
+    double trayDrive = voltage(motors[TRAY]) - TRAY_GRAVITY * (1 - tray.position / TRAY_TRAVEL);
+    stepAxis(&tray, trayDrive, TRAY_FREE_SPEED, TRAY_TIME_CONSTANT, dt);
+    hardStops(&tray, TRAY_TRAVEL);
+    simHardware.analog[TRAY_POTENTIOMETER] = TRAY_REST_RAW + (int)lround(tray.position) + noise();
+
+    // The switches pull their pins low when closed
+    simHardware.digital[TRAY_LIMIT_DOWN] = tray.position > TRAY_SWITCH_TRAVEL;
+    simHardware.digital[TRAY_LIMIT_UP] = tray.position < TRAY_TRAVEL - TRAY_SWITCH_TRAVEL;
+
+    double load = 0;
+    for(int port = 1; port <= SIM_MOTOR_PORTS; port++)
+    {
+        load += fabs(voltage(motors[port]));
+    }
+    double battery = restingBattery - BATTERY_DRAIN * (double)simNow() / 1e6 -
+        BATTERY_SAG_PER_MOTOR * load;
+    simHardware.battery = battery > 0 ? (unsigned int)battery : 0;
+}
+
+/**
+ * Prints where everything is
+ */
+void physicsPrint(bool header)
+{
+    if(header)
+    {
+        hostPrint("time,x,y,heading,left,right,arm,tray,battery\n");
+    }
+    hostPrint("%.3f,%.2f,%.2f,%.1f,%.2f,%.2f,%.0f,%.0f,%u\n", (double)simNow() / 1e6,
+        simHardware.x, simHardware.y, simHardware.heading, left.speed, right.speed, arm.position,
+        tray.position, simHardware.battery);
+}
@@ -0,0 +1,36 @@
+/** @file rename.h
+ * @brief Keeps the PROS stdio functions apart from the host's
+ *
+ * Forced into every simulation source except host.c (see the sim target in the Makefile). The
+ * PROS versions of these take a PROS_FILE * and have the same names as the host C library's,
+ * so the robot code's calls are renamed to the simulated ones in api.c. snprintf() and
+ * sprintf() have the same signatures on both, so the host's are used as they are.
+ */
+
+#ifndef SIM_RENAME_H_
+#define SIM_RENAME_H_
+
+#define fclose simFclose
+#define fcount simFcount
+#define fdelete simFdelete
+#define feof simFeof
+#define fflush simFflush
+#define fgetc simFgetc
+#define fgets simFgets
+#define fopen simFopen
+#define fprint simFprint
+#define fputc simFputc
+#define fputs simFputs
+#define fread simFread
+#define fseek simFseek
+#define ftell simFtell
+#define fwrite simFwrite
+#define getchar simGetchar
+#define print simPrint
+#define putchar simPutchar
+#define puts simPuts
+#define fprintf simFprintf
+#define printf simPrintf
+#define wait simWait
+
+#endif
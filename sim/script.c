@@ -0,0 +1,126 @@
+/** @file script.c
+ * @brief Joystick scripts
+ *
+ * A script is a list of changes to the controller: "1500 ch3 127" pushes the left stick up
+ * 1.5 s in, and "2000 6U 1" holds button 6 up from 2 s. Inputs keep their value until a later
+ * line changes them, and lines must be in time order. The inputs are ch1 to ch4, the buttons
+ * 5U, 5D, 6U, 6D and 7U, 7D, 7L, 7R, 8U, 8D, 8L, 8R, and lcdL, lcdC, lcdR for the LCD buttons.
+ */
+
+#include "sim.h"
+#include "host.h"
+
+// Longest script, in lines
+#define SCRIPT_LINES 1024
+
+static HostScriptLine script[SCRIPT_LINES];
+static int scriptLines;
+static int nextLine;
+
+/**
+ * Sets or clears bits of an input
+ */
+static void setBits(unsigned int *input, unsigned int bits, int value)
+{
+    if(value)
+    {
+        *input |= bits;
+    }
+    else
+    {
+        *input &= ~bits;
+    }
+}
+
+/**
+ * Finds what an input name refers to
+ *
+ * @param name The input
+ * @param axis Set to the axis number for ch1 to ch4
+ * @param buttons Set to the button word to change for a button
+ * @param bits Set to the bits for a button
+ * @return true if the input exists
+ */
+static bool parseInput(const char *name, int *axis, unsigned int **buttons, unsigned int *bits)
+{
+    *axis = 0;
+    if(name[0] == 'c' && name[1] == 'h' && name[2] >= '1' && name[2] <= '4' && !name[3])
+    {
+        *axis = name[2] - '0';
+        return true;
+    }
+    if(name[0] == 'l' && name[1] == 'c' && name[2] == 'd' && name[3] && !name[4])
+    {
+        *buttons = &simInputs.lcdButtons;
+        *bits = name[3] == 'L' ? LCD_BTN_LEFT : name[3] == 'C' ? LCD_BTN_CENTER :
+            name[3] == 'R' ? LCD_BTN_RIGHT : 0;
+        return *bits != 0;
+    }
+    if(name[0] < '5' || name[0] > '8' || !name[1] || name[2])
+    {
+        return false;
+    }
+    *buttons = &simInputs.buttons[name[0] - '0'];
+    *bits = name[1] == 'U' ? JOY_UP : name[1] == 'D' ? JOY_DOWN : 0;
+    if(name[0] >= '7')
+    {
+        *bits = *bits ? *bits : name[1] == 'L' ? JOY_LEFT : name[1] == 'R' ? JOY_RIGHT : 0;
+    }
+    return *bits != 0;
+}
+
+bool scriptLoad(const char *path)
+{
+    scriptLines = hostReadScript(path, script, SCRIPT_LINES);
+    if(scriptLines < 0)
+    {
+        scriptLines = 0;
+        return false;
+    }
+    for(int i = 0; i < scriptLines; i++)
+    {
+        int axis;
+        unsigned int *buttons;
+        unsigned int bits;
+        if(!parseInput(script[i].input, &axis, &buttons, &bits))
+        {
+            hostError("%s: unknown input %s at %u ms\n", path, script[i].input,
+                (unsigned int)script[i].time);
+            scriptLines = 0;
+            return false;
+        }
+        if(i > 0 && script[i].time < script[i - 1].time)
+        {
+            hostError("%s: line at %u ms is out of order\n", path, (unsigned int)script[i].time);
+            scriptLines = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+void scriptUpdate(unsigned long time)
+{
+    while(nextLine < scriptLines && script[nextLine].time <= time)
+    {
+        HostScriptLine *line = &script[nextLine++];
+        int axis;
+        unsigned int *buttons;
+        unsigned int bits;
+        parseInput(line->input, &axis, &buttons, &bits);
+        if(axis)
+        {
+            simInputs.axes[axis] = line->value > 127 ? 127 : line->value < -127 ? -127 :
+                line->value;
+        }
+        else
+        {
+            setBits(buttons, bits, line->value);
+        }
+    }
+}
+
+unsigned long scriptLength()
+{
+    return scriptLines ? script[scriptLines - 1].time : 0;
+}
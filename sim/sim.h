@@ -0,0 +1,159 @@
+/** @file sim.h
+ * @brief Desktop simulation of the robot
+ *
+ * The simulation builds the robot code in src/ (everything but the LED driver, which talks to
+ * the hardware directly) for the host and links it against a simulated PROS API:
+ *
+ * - kernel.c runs each task in its own thread, one at a time and highest priority first, on a
+ *   virtual clock. Time only moves on when every task is blocked, so the code runs as if the
+ *   Cortex were infinitely fast and a match takes a fraction of a second.
+ * - physics.c models the drive, arm and tray every millisecond of virtual time, including the
+ *   battery sagging under load and the limit switches.
+ * - script.c plays a joystick script into the controller and LCD buttons.
+ * - api.c implements the PROS functions the robot code calls on top of the rest.
+ *
+ * Build it with "make sim" and see main.c for the options.
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <API.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Physics step, in microseconds of virtual time
+#define SIM_STEP 1000
+
+// Highest motor, analog and digital port numbers
+#define SIM_MOTOR_PORTS 10
+#define SIM_ANALOG_PORTS 8
+#define SIM_DIGITAL_PORTS 12
+
+// The state of the robot's hardware. Ports index from 1, entry 0 is unused.
+typedef struct
+{
+    // Physical motor commands from motorSet()
+    int motors[SIM_MOTOR_PORTS + 1];
+    // Raw analog readings, 0 to 4095
+    int analog[SIM_ANALOG_PORTS + 1];
+    // Digital input levels
+    bool digital[SIM_DIGITAL_PORTS + 1];
+    // Encoder counts, by the encoder's top port
+    int encoders[SIM_DIGITAL_PORTS + 1];
+    // Gyro heading in degrees, counterclockwise
+    int gyro;
+    // Main battery in mV
+    unsigned int battery;
+
+    // Where the robot really is, for the report: inches and degrees
+    double x;
+    double y;
+    double heading;
+} SimHardware;
+
+extern SimHardware simHardware;
+
+// Controller and LCD inputs. Buttons of group g are bits of buttons[g], using the
+// JOY_* values.
+typedef struct
+{
+    int axes[5];
+    unsigned int buttons[9];
+    unsigned int lcdButtons;
+} SimInputs;
+
+extern SimInputs simInputs;
+
+// The text on the LCD
+extern char simLcd[2][17];
+
+// Whether the robot is enabled (set by main.c once initialize() is done)
+extern volatile bool simEnabled;
+
+/**
+ * @return Virtual time in microseconds
+ */
+uint64_t simNow();
+
+/**
+ * Starts the first task and runs the simulation until simFinish(). Never returns.
+ *
+ * @param endTime Virtual time in microseconds to stop at
+ */
+void simKernelRun(uint64_t endTime);
+
+/**
+ * Prints the report and ends the simulation. Never returns.
+ */
+void simFinish();
+
+/**
+ * Sets the hardware to a robot sitting still with everything lowered
+ *
+ * @param battery The starting battery voltage in mV
+ */
+void physicsInit(unsigned int battery);
+
+/**
+ * Moves the robot on by one SIM_STEP
+ */
+void physicsStep();
+
+/**
+ * Prints a CSV line of where the robot really is
+ *
+ * @param header Whether to print the column names first
+ */
+void physicsPrint(bool header);
+
+/**
+ * Called every SIM_STEP to run the pin change interrupts of inputs that changed
+ */
+void simCheckInterrupts();
+
+/**
+ * Copies a host file into the simulated flash
+ *
+ * @param name The flash file name
+ * @param path The host file
+ * @return true if it was copied
+ */
+bool simFlashLoad(const char *name, const char *path);
+
+/**
+ * Copies a file in the simulated flash out to the host
+ *
+ * @param name The flash file name
+ * @param path The host file to write
+ * @return true if the flash file exists and was copied
+ */
+bool simFlashSave(const char *name, const char *path);
+
+/**
+ * Loads a joystick script
+ *
+ * @param path The script file
+ * @return true if it loaded
+ */
+bool scriptLoad(const char *path);
+
+/**
+ * Applies the script lines that are due
+ *
+ * @param time Virtual time in ms
+ */
+void scriptUpdate(unsigned long time);
+
+/**
+ * @return The time of the last line of the script in ms, 0 without one
+ */
+unsigned long scriptLength();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,321 @@
+/** @file arm.c
+ * @brief Position controller for the intake arm
+ *
+ * Fixed point PID with a clamped integral, derivative on measurement (so target changes don't
+ * kick the output) and a slew limit on the output. The position and velocity come filtered
+ * from the sensor service (see sensors.h).
+ *
+ * A feedforward table holds the voltage it takes to hold the arm up against gravity at each
+ * position, so the PID terms only have to correct for what the table gets wrong. The gains and
+ * the table are part of the tuning config (see config.h).
+ */
+
+#include "main.h"
+#include "arm.h"
+#include "config.h"
+#include "motor.h"
+#include "sensors.h"
+#include "stack.h"
+
+// Aligned 32 bit reads and writes are atomic on the Cortex-M3, so the target, position and
+// output can be shared with other tasks without a mutex as long as only one task writes each
+static volatile int armTarget = ARM_LOWER_BOUND;
+static volatile int armPosition = 0;
+static volatile int armOutput = 0;
+
+static TaskHandle armTask = NULL;
+
+// Set by other tasks to start and stop learning, cleared by the arm task once it has seen them
+static volatile bool learnRequested = false;
+static volatile bool learnCancelRequested = false;
+static volatile bool learning = false;
+
+/**
+ * Progress of a feedforward learning sweep
+ */
+typedef struct
+{
+    // Point being learned, and whether the sweep is on its way back down
+    int point;
+    bool down;
+    // millis() when the point was first targeted and when the arm last came to rest there
+    unsigned long pointStart;
+    unsigned long settleStart;
+    bool settled;
+    // Sum and count of the outputs while at rest
+    int32_t outputSum;
+    unsigned int outputCount;
+    // Holding voltage found on the way up, or INT8_MIN if the point didn't settle
+    int8_t up[ARM_FEEDFORWARD_POINTS];
+    // How many points didn't settle
+    unsigned int failures;
+} LearnState;
+
+static LearnState learn;
+
+/**
+ * @param point A feedforward table index
+ * @return The arm position of the point
+ */
+static int pointPosition(int point)
+{
+    return ARM_LOWER_BOUND + point * (ARM_UPPER_BOUND - ARM_LOWER_BOUND) /
+        (ARM_FEEDFORWARD_POINTS - 1);
+}
+
+/**
+ * Looks up the holding voltage for a position, interpolating between the table points
+ *
+ * @param position The arm position
+ * @return The feedforward voltage
+ */
+static q16_t feedforwardAt(q16_t position)
+{
+    const q16_t span = q16FromInt(ARM_UPPER_BOUND - ARM_LOWER_BOUND);
+    q16_t offset = q16Clamp(position - q16FromInt(ARM_LOWER_BOUND), 0, span);
+
+    // Position along the table, in points
+    q16_t index = q16Saturate((int64_t)offset * (ARM_FEEDFORWARD_POINTS - 1) / (span >> 16));
+    int point = q16ToInt(index);
+    if(point >= ARM_FEEDFORWARD_POINTS - 1)
+    {
+        return q16FromInt(config.armFeedforward[ARM_FEEDFORWARD_POINTS - 1]);
+    }
+    return q16Lerp(q16FromInt(config.armFeedforward[point]),
+        q16FromInt(config.armFeedforward[point + 1]), index - q16FromInt(point));
+}
+
+/**
+ * Moves the sweep on to a point
+ */
+static void learnTarget(int point, bool down)
+{
+    learn.point = point;
+    learn.down = down;
+    learn.pointStart = millis();
+    learn.settled = false;
+    learn.outputSum = 0;
+    learn.outputCount = 0;
+}
+
+/**
+ * Records the output for the current point during a learning sweep, moving on to the next
+ * point once it's known
+ *
+ * @param error The position error
+ * @param velocity The arm velocity
+ * @param output The output for this period
+ * @return true once the sweep is done
+ */
+static bool learnUpdate(q16_t error, q16_t velocity, int output)
+{
+    unsigned long now = millis();
+    bool atRest = error > -q16FromInt(ARM_LEARN_TOLERANCE) &&
+        error < q16FromInt(ARM_LEARN_TOLERANCE) && velocity > -q16FromInt(ARM_LEARN_SPEED) &&
+        velocity < q16FromInt(ARM_LEARN_SPEED);
+
+    int result = INT8_MIN;
+    if(!atRest)
+    {
+        learn.settled = false;
+        learn.outputSum = 0;
+        learn.outputCount = 0;
+        if(now - learn.pointStart < ARM_LEARN_POINT_TIMEOUT)
+        {
+            return false;
+        }
+        learn.failures++;
+    }
+    else
+    {
+        if(!learn.settled)
+        {
+            learn.settled = true;
+            learn.settleStart = now;
+        }
+        learn.outputSum += output;
+        learn.outputCount++;
+        if(now - learn.settleStart < ARM_LEARN_SETTLE_TIME)
+        {
+            return false;
+        }
+        result = learn.outputSum / (int32_t)learn.outputCount;
+    }
+
+    if(!learn.down)
+    {
+        learn.up[learn.point] = result;
+        if(learn.point < ARM_FEEDFORWARD_POINTS - 1)
+        {
+            learnTarget(learn.point + 1, false);
+        }
+        else
+        {
+            learnTarget(learn.point, true);
+        }
+        return false;
+    }
+
+    // Use whichever directions settled
+    int up = learn.up[learn.point];
+    if(up != INT8_MIN && result != INT8_MIN)
+    {
+        config.armFeedforward[learn.point] = (up + result) / 2;
+    }
+    else if(up != INT8_MIN || result != INT8_MIN)
+    {
+        config.armFeedforward[learn.point] = up != INT8_MIN ? up : result;
+    }
+
+    if(learn.point == 0)
+    {
+        return true;
+    }
+    learnTarget(learn.point - 1, true);
+    return false;
+}
+
+/**
+ * The arm control loop. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void armControl(void *ignore)
+{
+    // The integral is stored pre-multiplied by the I gain so the clamp is simple
+    const q16_t integralLimit = q16FromInt(ARM_INTEGRAL_LIMIT);
+
+    q16_t integral = 0;
+    int output = 0;
+    bool wasEnabled = false;
+    unsigned long wakeTime = millis();
+
+    while(1)
+    {
+        SensorReading reading;
+        sensorGet(ARM_POTENTIOMETER, &reading);
+
+        // The kernel stops the motors while disabled, so the last written values can't be
+        // trusted once it is enabled again
+        bool enabled = isEnabled();
+        if(enabled && !wasEnabled)
+        {
+            motorOutInvalidate(ARM_PORTS);
+        }
+        wasEnabled = enabled;
+
+        if(learnRequested)
+        {
+            learnRequested = false;
+            learn.failures = 0;
+            learnTarget(0, false);
+            learning = true;
+        }
+        if(learnCancelRequested)
+        {
+            learnCancelRequested = false;
+            learning = false;
+        }
+
+        if(enabled)
+        {
+            int target = learning ? pointPosition(learn.point) : armTarget;
+            q16_t error = q16FromInt(target) - reading.value;
+
+            q16_t gravity = feedforwardAt(reading.value);
+            q16_t proportional = q16Mul(error, config.armKp);
+            // The gain is per unit of change per ARM_PERIOD, the velocity per second
+            q16_t derivative = q16Mul(reading.velocity, config.armKd) / (1000 / ARM_PERIOD);
+
+            // Only integrate while the output isn't already saturated in the same direction,
+            // so the integral can't wind up while the arm is pinned against a hard stop
+            int unsaturated = q16ToInt(gravity + proportional + integral - derivative);
+            if((unsaturated < 127 || error < 0) && (unsaturated > -127 || error > 0))
+            {
+                integral = q16Clamp(integral + q16Mul(error, config.armKi), -integralLimit,
+                    integralLimit);
+            }
+
+            int unslewed = clampInt(q16ToInt(gravity + proportional + integral - derivative),
+                -127, 127);
+            output = clampInt(unslewed, output - ARM_SLEW, output + ARM_SLEW);
+
+            if(learning && learnUpdate(error, reading.velocity, output))
+            {
+                learning = false;
+            }
+        }
+        else
+        {
+            // The kernel has the motors off while disabled, don't wind up in the meantime
+            integral = 0;
+            learning = false;
+            output = 0;
+        }
+
+        armPosition = q16ToInt(reading.value);
+        armOutput = output;
+
+        // Set the arm motors. Both are inverted in the motor table since positive voltage
+        // lowers the arm.
+        motorOutRequest(RIGHT_ARM, output, MOTOR_PRIORITY_DRIVER);
+        motorOutRequest(LEFT_ARM, output, MOTOR_PRIORITY_DRIVER);
+        motorOutSetSpeed(ARM_PORTS, reading.velocity / ARM_FREE_SPEED);
+        motorOutFlush(ARM_PORTS);
+
+        taskDelayUntil(&wakeTime, ARM_PERIOD);
+    }
+}
+
+void armInit()
+{
+    if(armTask == NULL)
+    {
+        armTask = stackTaskCreate("ARM", armControl, ARM_STACK_SIZE, NULL, ARM_TASK_PRIORITY);
+    }
+}
+
+void armSetTarget(int target)
+{
+    armTarget = clampInt(target, ARM_LOWER_BOUND, config.armUpperBound);
+}
+
+int armGetTarget()
+{
+    return armTarget;
+}
+
+int armGetPosition()
+{
+    return armPosition;
+}
+
+int armGetOutput()
+{
+    return armOutput;
+}
+
+void armLearnStart()
+{
+    learnRequested = true;
+}
+
+void armLearnCancel()
+{
+    learnCancelRequested = true;
+}
+
+bool armLearning()
+{
+    return learning || learnRequested;
+}
+
+void armPrintFeedforward(PROS_FILE *stream)
+{
+    fprintf(stream, "// Arm feedforward, %u points did not settle\r\n", learn.failures);
+    for(int i = 0; i < ARM_FEEDFORWARD_POINTS; i++)
+    {
+        fprintf(stream, "%s%d,%s", i % 16 == 0 ? "    " : " ", config.armFeedforward[i],
+            i % 16 == 15 ? "\r\n" : "");
+    }
+}
@@ -8,6 +8,27 @@
  */
 
 #include "main.h"
+#include "command.h"
+#include "config.h"
+#include "drive.h"
+#include "macros.h"
+#include "motor.h"
+#include "path.h"
+
+// Period of the autonomous loop in ms
+#define AUTON_PERIOD PATH_PERIOD
+
+// Motor ports written by the autonomous task. The arm, drive and tray ports belong to their
+// own tasks.
+#define AUTON_PORTS ROLLER_PORTS
+
+// Drive the path while intaking, then stack the cubes
+static Command drivePath = PATH_COMMAND("drivePath", NULL);
+static Command intake = COMMAND_POWER("intake", ROLLER_PORTS, 127, 0);
+static Command *const collectChildren[] = {&drivePath, &intake};
+static Command collect = COMMAND_RACE("collect", collectChildren);
+static Command *const autonChildren[] = {&collect, &dropOffCommand};
+static Command auton = COMMAND_SEQUENCE("auton", autonChildren);
 
 /*
  * Runs the user autonomous code. This function will be started in its own task with the default
@@ -24,4 +45,39 @@
  * so, the robot will await a switch to another mode or disable/enable cycle.
  */
 void autonomous() {
+    // Like operatorControl(), this task may have been stopped in the middle of everything
+    commandCancelAll();
+    motorOutInvalidate(AUTON_PORTS);
+    driveReset();
+
+    // The selection after the last path replays the recorded driver run, if there is one
+    unsigned int selection = (unsigned int)config.autonSelection;
+    if(selection == autonPathCount)
+    {
+        operatorReplay();
+    }
+
+    drivePath.data = autonPaths[selection < autonPathCount ? selection : 0];
+    commandStart(&auton);
+
+    unsigned long wakeTime = millis();
+    while(commandIsRunning(&auton))
+    {
+        commandRun();
+        driveFlush();
+        motorOutFlush(AUTON_PORTS);
+        taskDelayUntil(&wakeTime, AUTON_PERIOD);
+    }
+
+    // Ports keep their last value once nothing requests them, so stop everything
+    for(unsigned char port = 1; port <= MOTOR_PORTS; port++)
+    {
+        if(AUTON_PORTS & MOTOR_PORT_BIT(port))
+        {
+            motorOutRequest(port, 0, MOTOR_PRIORITY_MACRO);
+        }
+    }
+    driveRequest(0, 0, MOTOR_PRIORITY_MACRO);
+    driveFlush();
+    motorOutFlush(AUTON_PORTS);
 }
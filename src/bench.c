@@ -0,0 +1,196 @@
+/** @file bench.c
+ * @brief Micro-benchmarks of the calls in the control loop
+ */
+
+#include "main.h"
+#include "bench.h"
+#include "fixed.h"
+#include "timing.h"
+
+#if BENCH
+
+/**
+ * One benchmark: a function that does one call of the primitive being timed
+ */
+typedef struct
+{
+    const char *name;
+    void (*run)(unsigned int i);
+    unsigned int iterations;
+} Bench;
+
+// Operands for the multiplies, volatile so the compiler can't fold them
+static volatile float floatA = 1.2345f;
+static volatile float floatB = 0.5432f;
+static volatile q16_t fixedA = Q16(1.2345);
+static volatile q16_t fixedB = Q16(0.5432);
+// Results, volatile so the calls aren't thrown away
+static volatile int sink;
+static volatile float floatSink;
+
+static Semaphore ping;
+static Semaphore pong;
+static Mutex mutex;
+
+static void benchEmpty(unsigned int i)
+{
+}
+
+static void benchMotorSet(unsigned int i)
+{
+    motorSet(BENCH_MOTOR_PORT, 0);
+}
+
+static void benchAnalogRead(unsigned int i)
+{
+    sink = analogReadCalibrated(ARM_POTENTIOMETER);
+}
+
+static void benchJoystickDigital(unsigned int i)
+{
+    sink = joystickGetDigital(1, 5, JOY_UP);
+}
+
+static void benchFloatMultiply(unsigned int i)
+{
+    floatSink = floatA * floatB;
+}
+
+static void benchFixedMultiply(unsigned int i)
+{
+    sink = q16Mul(fixedA, fixedB);
+}
+
+static void benchLcdPrint(unsigned int i)
+{
+    lcdPrint(LCD_PORT, 1, "bench %u", i);
+}
+
+static void benchUartWrite(unsigned int i)
+{
+    static const char data[BENCH_WRITE_SIZE] = "0123456789abcde\n";
+    fwrite(data, 1, sizeof(data), BENCH_UART);
+}
+
+static void benchSemaphore(unsigned int i)
+{
+    semaphoreGive(ping);
+    semaphoreTake(ping, 0);
+}
+
+static void benchMutex(unsigned int i)
+{
+    mutexTake(mutex, -1);
+    mutexGive(mutex);
+}
+
+/**
+ * Hands the processor to the partner task and waits for it to hand it back, so one call is
+ * two context switches (and two semaphore give/take pairs)
+ */
+static void benchTaskSwitch(unsigned int i)
+{
+    semaphoreGive(ping);
+    semaphoreTake(pong, -1);
+}
+
+/**
+ * The other half of benchTaskSwitch()
+ */
+static void partnerTask(void *ignore)
+{
+    while(true)
+    {
+        semaphoreTake(ping, -1);
+        semaphoreGive(pong);
+    }
+}
+
+static const Bench benches[] = {
+    {"motorSet", benchMotorSet, BENCH_ITERATIONS},
+    {"analogReadCal", benchAnalogRead, BENCH_ITERATIONS},
+    {"joystickDigital", benchJoystickDigital, BENCH_ITERATIONS},
+    {"float multiply", benchFloatMultiply, BENCH_ITERATIONS},
+    {"q16Mul", benchFixedMultiply, BENCH_ITERATIONS},
+    // The LCD and UART are slow enough that a full run would take seconds
+    {"lcdPrint", benchLcdPrint, BENCH_ITERATIONS / 10},
+    {"fwrite uart", benchUartWrite, BENCH_ITERATIONS / 10},
+    {"semaphore", benchSemaphore, BENCH_ITERATIONS},
+    {"mutex", benchMutex, BENCH_ITERATIONS},
+    {"task switch x2", benchTaskSwitch, BENCH_ITERATIONS},
+};
+
+/**
+ * Times a benchmark
+ *
+ * @return The total time of all its calls in timer units
+ */
+static uint32_t measure(const Bench *bench)
+{
+    uint32_t start = timingNow();
+    for(unsigned int i = 0; i < bench->iterations; i++)
+    {
+        bench->run(i);
+    }
+    return timingNow() - start;
+}
+
+void benchInit()
+{
+    timingInit();
+    analogCalibrate(ARM_POTENTIOMETER);
+    lcdInit(LCD_PORT);
+}
+
+void benchRun()
+{
+    taskPrioritySet(NULL, TASK_PRIORITY_HIGHEST);
+    usartInit(BENCH_UART, BENCH_UART_BAUD, SERIAL_8N1);
+    ping = semaphoreCreate();
+    pong = semaphoreCreate();
+    mutex = mutexCreate();
+    // semaphoreCreate() makes semaphores that start given
+    semaphoreTake(ping, 0);
+    semaphoreTake(pong, 0);
+
+    const Bench empty = {"empty", benchEmpty, BENCH_ITERATIONS};
+    uint32_t overhead = measure(&empty);
+
+    printf("%-16s %6s %10s %8s\r\n", "bench", "calls", "cycles", "us");
+    for(unsigned int i = 0; i < sizeof(benches) / sizeof(benches[0]); i++)
+    {
+        const Bench *bench = &benches[i];
+        TaskHandle partner = NULL;
+        if(bench->run == benchTaskSwitch)
+        {
+            partner = taskCreate(partnerTask, TASK_MINIMAL_STACK_SIZE, NULL,
+                TASK_PRIORITY_HIGHEST);
+        }
+
+        uint32_t total = measure(bench);
+        uint32_t loop = (uint32_t)((uint64_t)overhead * bench->iterations / BENCH_ITERATIONS);
+        uint32_t units = (total > loop ? total - loop : 0) / bench->iterations;
+#if TIMING_USE_DWT
+        uint32_t cycles = units;
+#else
+        uint32_t cycles = units * TIMING_CYCLES_PER_US;
+#endif
+        // Hundredths of a microsecond
+        uint32_t hundredths = cycles * 100 / TIMING_CYCLES_PER_US;
+        printf("%-16s %6u %10lu %5lu.%02lu\r\n", bench->name, bench->iterations,
+            (unsigned long)cycles, (unsigned long)(hundredths / 100),
+            (unsigned long)(hundredths % 100));
+
+        if(partner != NULL)
+        {
+            taskDelete(partner);
+        }
+    }
+
+    while(true)
+    {
+        delay(1000);
+    }
+}
+
+#endif
@@ -0,0 +1,266 @@
+/** @file command.c
+ * @brief Cooperative commands for autonomous and macros
+ */
+
+#include "main.h"
+#include "command.h"
+#include "drive.h"
+#include "motor.h"
+#include "switches.h"
+
+// Top level commands started with commandStart(), NULL for free slots
+static Command *running[COMMAND_MAX_RUNNING];
+
+// Switch events for the commands, and the pins pressed since the last tick (bit pin - 1)
+static SwitchListener switchListener;
+static uint16_t switchesPressed = 0;
+
+/**
+ * Starts a command without checking its requirements
+ */
+static void begin(Command *command)
+{
+    command->startTime = millis();
+    command->running = true;
+    if(command->init != NULL)
+    {
+        command->init(command);
+    }
+}
+
+/**
+ * Stops a running command
+ */
+static void finish(Command *command, bool interrupted)
+{
+    command->running = false;
+    if(command->end != NULL)
+    {
+        command->end(command, interrupted);
+    }
+}
+
+/**
+ * Runs a command for one tick and ends it if it finished or timed out
+ *
+ * @return true if the command ended
+ */
+static bool step(Command *command)
+{
+    if(command->execute != NULL)
+    {
+        command->execute(command);
+    }
+
+    bool finished = command->isFinished != NULL && command->isFinished(command);
+    bool timedOut = command->timeout != 0 && millis() - command->startTime >= command->timeout;
+    if(finished || timedOut)
+    {
+        finish(command, !finished);
+        return true;
+    }
+    return false;
+}
+
+bool commandStart(Command *command)
+{
+    if(command->running)
+    {
+        return true;
+    }
+
+    uint16_t requirements = commandRequirements(command);
+    int freeSlot = -1;
+    for(int i = 0; i < COMMAND_MAX_RUNNING; i++)
+    {
+        if(running[i] != NULL && (commandRequirements(running[i]) & requirements) != 0)
+        {
+            finish(running[i], true);
+            running[i] = NULL;
+        }
+        if(running[i] == NULL && freeSlot < 0)
+        {
+            freeSlot = i;
+        }
+    }
+
+    if(freeSlot < 0)
+    {
+        return false;
+    }
+
+    running[freeSlot] = command;
+    begin(command);
+    return true;
+}
+
+void commandCancel(Command *command)
+{
+    for(int i = 0; i < COMMAND_MAX_RUNNING; i++)
+    {
+        if(running[i] == command)
+        {
+            finish(command, true);
+            running[i] = NULL;
+        }
+    }
+}
+
+void commandCancelAll()
+{
+    for(int i = 0; i < COMMAND_MAX_RUNNING; i++)
+    {
+        if(running[i] != NULL)
+        {
+            finish(running[i], true);
+            running[i] = NULL;
+        }
+    }
+    switchesListen(&switchListener);
+    switchesPressed = 0;
+}
+
+void commandRun()
+{
+    SwitchEvent event;
+    switchesPressed = 0;
+    while(switchesNext(&switchListener, &event))
+    {
+        if(event.pressed)
+        {
+            switchesPressed |= 1 << (event.pin - 1);
+        }
+    }
+
+    for(int i = 0; i < COMMAND_MAX_RUNNING; i++)
+    {
+        if(running[i] != NULL && step(running[i]))
+        {
+            running[i] = NULL;
+        }
+    }
+}
+
+bool commandUsing(uint16_t ports)
+{
+    for(int i = 0; i < COMMAND_MAX_RUNNING; i++)
+    {
+        if(running[i] != NULL && (commandRequirements(running[i]) & ports) != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool commandSwitchPressed(unsigned char pin)
+{
+    return pin >= 1 && pin <= 16 && (switchesPressed & (1 << (pin - 1)));
+}
+
+bool commandIsRunning(const Command *command)
+{
+    return command->running;
+}
+
+uint16_t commandRequirements(const Command *command)
+{
+    uint16_t requirements = command->requirements;
+    for(unsigned int i = 0; i < command->childCount; i++)
+    {
+        requirements |= commandRequirements(command->children[i]);
+    }
+    return requirements;
+}
+
+void commandSequenceInit(Command *command)
+{
+    command->currentChild = 0;
+    if(command->childCount > 0)
+    {
+        begin(command->children[0]);
+    }
+}
+
+void commandSequenceExecute(Command *command)
+{
+    if(command->currentChild < command->childCount &&
+        step(command->children[command->currentChild]))
+    {
+        // The next child starts now and first executes on the next tick
+        command->currentChild++;
+        if(command->currentChild < command->childCount)
+        {
+            begin(command->children[command->currentChild]);
+        }
+    }
+}
+
+bool commandSequenceIsFinished(Command *command)
+{
+    return command->currentChild >= command->childCount;
+}
+
+void commandParallelInit(Command *command)
+{
+    command->finishedChildren = 0;
+    for(unsigned int i = 0; i < command->childCount; i++)
+    {
+        begin(command->children[i]);
+    }
+}
+
+void commandParallelExecute(Command *command)
+{
+    for(unsigned int i = 0; i < command->childCount; i++)
+    {
+        CommandChildMask bit = (CommandChildMask)1 << i;
+        if(!(command->finishedChildren & bit) && step(command->children[i]))
+        {
+            command->finishedChildren |= bit;
+        }
+    }
+}
+
+bool commandParallelIsFinished(Command *command)
+{
+    // Shifted down from all ones, since shifting 1 up by the width of the mask isn't defined
+    const unsigned int width = sizeof(CommandChildMask) * 8;
+    CommandChildMask all = command->childCount == 0 ? 0 :
+        (CommandChildMask)~(CommandChildMask)0 >> (width - command->childCount);
+    return command->finishedChildren == all;
+}
+
+bool commandRaceIsFinished(Command *command)
+{
+    return command->finishedChildren != 0 || command->childCount == 0;
+}
+
+void commandGroupEnd(Command *command, bool interrupted)
+{
+    // A race leaves its other children running, and anything interrupted may have children
+    // part way through
+    for(unsigned int i = 0; i < command->childCount; i++)
+    {
+        if(command->children[i]->running)
+        {
+            finish(command->children[i], true);
+        }
+    }
+}
+
+void commandPowerExecute(Command *command)
+{
+    // The drive motors belong to the drive task
+    if(command->requirements & DRIVE_PORTS)
+    {
+        driveRequest(command->args[0], command->args[0], MOTOR_PRIORITY_MACRO);
+    }
+    for(unsigned char port = 1; port <= MOTOR_PORTS; port++)
+    {
+        if((command->requirements & ~DRIVE_PORTS) & MOTOR_PORT_BIT(port))
+        {
+            motorOutRequest(port, command->args[0], MOTOR_PRIORITY_MACRO);
+        }
+    }
+}
@@ -0,0 +1,433 @@
+/** @file config.c
+ * @brief Tuning values stored in flash
+ */
+
+#include "main.h"
+#include "config.h"
+#include "drive.h"
+#include "macros.h"
+#include "replay.h"
+#include "stack.h"
+#include "tray.h"
+
+// For offsetof()
+#include <stddef.h>
+
+// Longest line the console reads
+#define CONSOLE_LINE_LENGTH 48
+
+#define FIELD_INT(field, low, high, change) \
+    {#field, CONFIG_INT, offsetof(Config, field), (low), (high), (change)}
+#define FIELD_Q16(field, low, high, change) \
+    {#field, CONFIG_Q16, offsetof(Config, field), Q16(low), Q16(high), Q16(change)}
+
+const ConfigField configFields[] =
+{
+    FIELD_Q16(armKp, 0.0, 2.0, 0.01),
+    FIELD_Q16(armKi, 0.0, 0.1, 0.0005),
+    FIELD_Q16(armKd, 0.0, 4.0, 0.05),
+    FIELD_INT(armUpperBound, ARM_LOWER_BOUND, ARM_UPPER_BOUND, 50),
+    FIELD_INT(armIncrement, 1, 200, 5),
+    FIELD_INT(trayStackPosition, TRAY_LOWER_BOUND, TRAY_UPPER_BOUND, 25),
+    FIELD_Q16(trayKp, 0.0, 1.0, 0.01),
+    FIELD_INT(backupSpeed, 0, 127, 5),
+    FIELD_INT(driveVelocity, 0, 1, 1),
+    FIELD_Q16(driveKv, 0.0, 12.0, 0.1),
+    FIELD_Q16(driveKp, 0.0, 20.0, 0.25),
+    FIELD_Q16(driveKi, 0.0, 1.0, 0.01),
+    FIELD_INT(autonSelection, 0, 15, 1),
+};
+
+const unsigned int configFieldCount = sizeof(configFields) / sizeof(configFields[0]);
+
+static const Config defaults =
+{
+    .magic = CONFIG_MAGIC,
+    .version = CONFIG_VERSION,
+    .size = sizeof(Config),
+    .sequence = 0,
+    .armKp = ARM_KP,
+    .armKi = ARM_KI,
+    .armKd = ARM_KD,
+    .armUpperBound = ARM_UPPER_BOUND,
+    .armIncrement = IDEAL_ARM_INCREMENT,
+    .trayStackPosition = TRAY_STACK_POSITION,
+    .trayKp = TRAY_KP,
+    .backupSpeed = BACKUP_SPEED,
+    .driveVelocity = 0,
+    .driveKv = DRIVE_KV,
+    .driveKp = DRIVE_KP,
+    .driveKi = DRIVE_KI,
+    .autonSelection = 0,
+    .armFeedforward = {0},
+};
+
+Config config;
+
+// What is in flash (or the defaults if nothing is), to skip saves that change nothing
+static Config saved;
+
+static TaskHandle consoleTask = NULL;
+
+// Held while changing or saving config, since the console and the LCD menu do both from their
+// own tasks
+static Mutex configMutex = NULL;
+
+/**
+ * @return The CRC-16/CCITT of a record, covering everything before the crc field
+ */
+static uint16_t recordCrc(const Config *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint16_t crc = 0xFFFF;
+    for(size_t i = 0; i < offsetof(Config, crc); i++)
+    {
+        crc ^= (uint16_t)(bytes[i] << 8);
+        for(int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * Reads and checks the record in a file
+ *
+ * @param name The file name
+ * @param record Set to the record
+ * @return true if the file holds a valid record of this version
+ */
+static bool readRecord(const char *name, Config *record)
+{
+    PROS_FILE *file = fopen(name, "r");
+    if(file == NULL)
+    {
+        return false;
+    }
+    size_t read = fread(record, 1, sizeof(Config), file);
+    fclose(file);
+
+    return read == sizeof(Config) && record->magic == CONFIG_MAGIC &&
+        record->version == CONFIG_VERSION && record->size == sizeof(Config) &&
+        record->crc == recordCrc(record);
+}
+
+/**
+ * @return true if two records hold the same values, ignoring the sequence and CRC
+ */
+static bool sameValues(const Config *a, const Config *b)
+{
+    const uint8_t *aBytes = (const uint8_t *)a;
+    const uint8_t *bBytes = (const uint8_t *)b;
+    for(size_t i = offsetof(Config, armKp); i < offsetof(Config, crc); i++)
+    {
+        if(aBytes[i] != bBytes[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @return A pointer to a field's value in config
+ */
+static int32_t *fieldValue(unsigned int field)
+{
+    return (int32_t *)((uint8_t *)&config + configFields[field].offset);
+}
+
+/**
+ * Compares a field name against a word of a command
+ *
+ * @return true if the word (up to a space or the end) is the name
+ */
+static bool wordIs(const char *word, const char *name)
+{
+    while(*name != '\0' && *word == *name)
+    {
+        word++;
+        name++;
+    }
+    return *name == '\0' && (*word == ' ' || *word == '\0');
+}
+
+void configLoad()
+{
+    Config first;
+    Config second;
+    bool firstValid = readRecord(CONFIG_FILE_0, &first);
+    bool secondValid = readRecord(CONFIG_FILE_1, &second);
+
+    if(firstValid && (!secondValid || (int32_t)(first.sequence - second.sequence) > 0))
+    {
+        config = first;
+    }
+    else if(secondValid)
+    {
+        config = second;
+    }
+    else
+    {
+        config = defaults;
+    }
+    saved = config;
+
+    if(configMutex == NULL)
+    {
+        configMutex = mutexCreate();
+    }
+}
+
+/**
+ * Does the work of configSave(), with configMutex held
+ */
+static bool saveLocked()
+{
+    if(sameValues(&config, &saved))
+    {
+        return true;
+    }
+    if(isEnabled())
+    {
+        return false;
+    }
+
+    Config record = config;
+    record.sequence = saved.sequence + 1;
+    record.crc = recordCrc(&record);
+
+    // Odd sequences go in the second file, so the newest good record is never overwritten
+    PROS_FILE *file = fopen((record.sequence & 1) ? CONFIG_FILE_1 : CONFIG_FILE_0, "w");
+    if(file == NULL)
+    {
+        return false;
+    }
+    size_t written = fwrite(&record, 1, sizeof(Config), file);
+    fclose(file);
+    if(written != sizeof(Config))
+    {
+        return false;
+    }
+
+    config.sequence = record.sequence;
+    config.crc = record.crc;
+    saved = config;
+    return true;
+}
+
+bool configSave()
+{
+    mutexTake(configMutex, -1);
+    bool result = saveLocked();
+    mutexGive(configMutex);
+    return result;
+}
+
+void configReset()
+{
+    mutexTake(configMutex, -1);
+    uint32_t sequence = config.sequence;
+    config = defaults;
+    config.sequence = sequence;
+    mutexGive(configMutex);
+}
+
+unsigned int configFind(const char *name)
+{
+    unsigned int field = 0;
+    while(field < configFieldCount && !wordIs(name, configFields[field].name))
+    {
+        field++;
+    }
+    return field;
+}
+
+int32_t configGet(unsigned int field)
+{
+    return field < configFieldCount ? *fieldValue(field) : 0;
+}
+
+void configSet(unsigned int field, int32_t value)
+{
+    if(field < configFieldCount)
+    {
+        mutexTake(configMutex, -1);
+        *fieldValue(field) = value < configFields[field].min ? configFields[field].min :
+            value > configFields[field].max ? configFields[field].max : value;
+        mutexGive(configMutex);
+    }
+}
+
+void configFormat(unsigned int field, char *buffer, size_t size)
+{
+    int32_t value = configGet(field);
+    if(field >= configFieldCount || configFields[field].type == CONFIG_INT)
+    {
+        snprintf(buffer, size, "%ld", (long)value);
+        return;
+    }
+
+    // Round to 3 decimal places
+    bool negative = value < 0;
+    uint32_t magnitude = negative ? -(uint32_t)value : (uint32_t)value;
+    uint32_t thousandths = (uint32_t)(((uint64_t)magnitude * 1000 + 32768) >> 16);
+    snprintf(buffer, size, "%s%lu.%03lu", negative ? "-" : "", (unsigned long)(thousandths / 1000),
+        (unsigned long)(thousandths % 1000));
+}
+
+/**
+ * Parses a decimal number such as "-0.125" into the given type
+ *
+ * @param text The text, which must be the whole number
+ * @param type Whether to parse into an integer or Q16
+ * @param value Set to the parsed value
+ * @return true if the text was a number
+ */
+static bool parseValue(const char *text, ConfigType type, int32_t *value)
+{
+    bool negative = *text == '-';
+    if(negative)
+    {
+        text++;
+    }
+    if(*text < '0' || *text > '9')
+    {
+        return false;
+    }
+
+    int64_t whole = 0;
+    while(*text >= '0' && *text <= '9' && whole < 100000)
+    {
+        whole = whole * 10 + (*text++ - '0');
+    }
+
+    // Fractional digits, as a fraction of 10^digits
+    int64_t fraction = 0;
+    int64_t scale = 1;
+    if(*text == '.')
+    {
+        text++;
+        while(*text >= '0' && *text <= '9')
+        {
+            if(scale < 100000000)
+            {
+                fraction = fraction * 10 + (*text - '0');
+                scale *= 10;
+            }
+            text++;
+        }
+    }
+    if(*text != '\0')
+    {
+        return false;
+    }
+
+    int64_t result = type == CONFIG_Q16 ? (whole << 16) + (fraction << 16) / scale : whole;
+    *value = (int32_t)(negative ? -result : result);
+    return true;
+}
+
+/**
+ * Runs one console command
+ */
+static void consoleCommand(char *line)
+{
+    char text[16];
+
+    if(wordIs(line, "get"))
+    {
+        for(unsigned int i = 0; i < configFieldCount; i++)
+        {
+            configFormat(i, text, sizeof(text));
+            printf("%s = %s\r\n", configFields[i].name, text);
+        }
+    }
+    else if(wordIs(line, "set"))
+    {
+        char *name = line + 4;
+        char *value = name;
+        while(*value != ' ' && *value != '\0')
+        {
+            value++;
+        }
+        if(*value == ' ')
+        {
+            value++;
+        }
+
+        unsigned int field = configFind(name);
+        int32_t parsed;
+        if(field >= configFieldCount)
+        {
+            printf("no such field\r\n");
+        }
+        else if(parseValue(value, configFields[field].type, &parsed))
+        {
+            configSet(field, parsed);
+            configFormat(field, text, sizeof(text));
+            printf("%s = %s\r\n", configFields[field].name, text);
+        }
+        else
+        {
+            printf("bad value\r\n");
+        }
+    }
+    else if(wordIs(line, "save"))
+    {
+        printf("%s\r\n", configSave() ? "saved" : "save failed (disable the robot first)");
+    }
+    else if(wordIs(line, "reset"))
+    {
+        configReset();
+        printf("reset to defaults\r\n");
+    }
+    else if(wordIs(line, "replay"))
+    {
+        replayPrint(stdout);
+    }
+    else if(*line != '\0')
+    {
+        printf("commands: get, set <name> <value>, save, reset, replay\r\n");
+    }
+}
+
+/**
+ * Reads commands from stdin. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void configConsole(void *ignore)
+{
+    char line[CONSOLE_LINE_LENGTH];
+
+    while(1)
+    {
+        if(fgets(line, sizeof(line), stdin) == NULL)
+        {
+            delay(100);
+            continue;
+        }
+
+        // Strip the line ending
+        for(char *end = line; *end != '\0'; end++)
+        {
+            if(*end == '\r' || *end == '\n')
+            {
+                *end = '\0';
+                break;
+            }
+        }
+        consoleCommand(line);
+    }
+}
+
+void configConsoleInit()
+{
+    if(consoleTask == NULL)
+    {
+        consoleTask = stackTaskCreate("CONFIG_CONSOLE", configConsole, CONFIG_CONSOLE_STACK_SIZE,
+            NULL, CONFIG_CONSOLE_PRIORITY);
+    }
+}
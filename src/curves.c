@@ -0,0 +1,50 @@
+/** @file curves.c
+ * @brief Joystick response curve lookup tables
+ *
+ * Generated by tools/gencurves.py, do not edit by hand.
+ */
+
+#include "main.h"
+#include "curves.h"
+
+// scale 1.0000, expo 0.00, deadband 15
+const int8_t forwardCurve[256] =
+{
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,   15,  // 0
+      16,   17,   18,   19,   20,   21,   22,   23,   24,   25,   26,   27,   28,   29,   30,   31,  // 16
+      32,   33,   34,   35,   36,   37,   38,   39,   40,   41,   42,   43,   44,   45,   46,   47,  // 32
+      48,   49,   50,   51,   52,   53,   54,   55,   56,   57,   58,   59,   60,   61,   62,   63,  // 48
+      64,   65,   66,   67,   68,   69,   70,   71,   72,   73,   74,   75,   76,   77,   78,   79,  // 64
+      80,   81,   82,   83,   84,   85,   86,   87,   88,   89,   90,   91,   92,   93,   94,   95,  // 80
+      96,   97,   98,   99,  100,  101,  102,  103,  104,  105,  106,  107,  108,  109,  110,  111,  // 96
+     112,  113,  114,  115,  116,  117,  118,  119,  120,  121,  122,  123,  124,  125,  126,  127,  // 112
+    -127, -127, -126, -125, -124, -123, -122, -121, -120, -119, -118, -117, -116, -115, -114, -113,  // -128
+    -112, -111, -110, -109, -108, -107, -106, -105, -104, -103, -102, -101, -100,  -99,  -98,  -97,  // -112
+     -96,  -95,  -94,  -93,  -92,  -91,  -90,  -89,  -88,  -87,  -86,  -85,  -84,  -83,  -82,  -81,  // -96
+     -80,  -79,  -78,  -77,  -76,  -75,  -74,  -73,  -72,  -71,  -70,  -69,  -68,  -67,  -66,  -65,  // -80
+     -64,  -63,  -62,  -61,  -60,  -59,  -58,  -57,  -56,  -55,  -54,  -53,  -52,  -51,  -50,  -49,  // -64
+     -48,  -47,  -46,  -45,  -44,  -43,  -42,  -41,  -40,  -39,  -38,  -37,  -36,  -35,  -34,  -33,  // -48
+     -32,  -31,  -30,  -29,  -28,  -27,  -26,  -25,  -24,  -23,  -22,  -21,  -20,  -19,  -18,  -17,  // -32
+     -16,  -15,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // -16
+};
+
+// scale 0.7143, expo 0.00, deadband 15
+const int8_t turnCurve[256] =
+{
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 0
+       0,    0,    0,    0,    0,   15,   16,   16,   17,   18,   19,   19,   20,   21,   21,   22,  // 16
+      23,   24,   24,   25,   26,   26,   27,   28,   29,   29,   30,   31,   31,   32,   33,   34,  // 32
+      34,   35,   36,   36,   37,   38,   39,   39,   40,   41,   41,   42,   43,   44,   44,   45,  // 48
+      46,   46,   47,   48,   49,   49,   50,   51,   51,   52,   53,   54,   54,   55,   56,   56,  // 64
+      57,   58,   59,   59,   60,   61,   61,   62,   63,   64,   64,   65,   66,   66,   67,   68,  // 80
+      69,   69,   70,   71,   71,   72,   73,   74,   74,   75,   76,   76,   77,   78,   79,   79,  // 96
+      80,   81,   81,   82,   83,   84,   84,   85,   86,   86,   87,   88,   89,   89,   90,   91,  // 112
+     -91,  -91,  -90,  -89,  -89,  -88,  -87,  -86,  -86,  -85,  -84,  -84,  -83,  -82,  -81,  -81,  // -128
+     -80,  -79,  -79,  -78,  -77,  -76,  -76,  -75,  -74,  -74,  -73,  -72,  -71,  -71,  -70,  -69,  // -112
+     -69,  -68,  -67,  -66,  -66,  -65,  -64,  -64,  -63,  -62,  -61,  -61,  -60,  -59,  -59,  -58,  // -96
+     -57,  -56,  -56,  -55,  -54,  -54,  -53,  -52,  -51,  -51,  -50,  -49,  -49,  -48,  -47,  -46,  // -80
+     -46,  -45,  -44,  -44,  -43,  -42,  -41,  -41,  -40,  -39,  -39,  -38,  -37,  -36,  -36,  -35,  // -64
+     -34,  -34,  -33,  -32,  -31,  -31,  -30,  -29,  -29,  -28,  -27,  -26,  -26,  -25,  -24,  -24,  // -48
+     -23,  -22,  -21,  -21,  -20,  -19,  -19,  -18,  -17,  -16,  -16,  -15,    0,    0,    0,    0,  // -32
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // -16
+};
@@ -0,0 +1,172 @@
+/** @file drive.c
+ * @brief Drive base output and velocity control
+ */
+
+#include "main.h"
+#include "config.h"
+#include "drive.h"
+#include "motor.h"
+#include "odometry.h"
+#include "stack.h"
+
+// A request is packed into one word, left side high, so the drive task always reads both sides
+// of the same request without a lock
+#define PACK(left, right) (((uint32_t)(uint16_t)(left) << 16) | (uint16_t)(right))
+#define UNPACK_LEFT(packed) ((int)(int16_t)((packed) >> 16))
+#define UNPACK_RIGHT(packed) ((int)(int16_t)(packed))
+
+// odometryGetWheelSpeeds() retries while the odometry task is part way through an update, which
+// only works if the odometry task can't be preempted by the reader
+_Static_assert(DRIVE_TASK_PRIORITY < ODOMETRY_TASK_PRIORITY,
+    "the drive task must be below the odometry task");
+
+// Request of the current tick, only touched by the requesting task. Priority 0 means nothing
+// was requested.
+static int requestLeft = 0;
+static int requestRight = 0;
+static unsigned int requestPriority = 0;
+
+// Last flushed request
+static volatile uint32_t target = 0;
+
+static TaskHandle driveTask = NULL;
+
+/**
+ * State of the velocity loop for one side
+ */
+typedef struct
+{
+    // Pre-multiplied by the I gain so the clamp is simple
+    q16_t integral;
+} DriveSide;
+
+/**
+ * Runs the velocity loop of one side for a period
+ *
+ * @param side The side's loop state
+ * @param request The requested fraction of DRIVE_MAX_SPEED, -127 to 127
+ * @param speed The measured speed in inches per second
+ * @return The output voltage
+ */
+static int velocityUpdate(DriveSide *side, int request, q16_t speed)
+{
+    const q16_t integralLimit = q16FromInt(DRIVE_INTEGRAL_LIMIT);
+
+    q16_t targetSpeed = request * Q16(DRIVE_MAX_SPEED / 127.0);
+    q16_t error = targetSpeed - speed;
+
+    // Nothing to hold at a standstill, and a leftover integral would make the robot creep
+    if(request == 0)
+    {
+        side->integral = 0;
+        return 0;
+    }
+
+    q16_t feedforward = q16Mul(targetSpeed, config.driveKv);
+    q16_t proportional = q16Mul(error, config.driveKp);
+
+    // Like the arm, only integrate while the output isn't already saturated the same way
+    int unsaturated = q16ToInt(feedforward + proportional + side->integral);
+    if((unsaturated < 127 || error < 0) && (unsaturated > -127 || error > 0))
+    {
+        side->integral = q16Clamp(side->integral + q16Mul(error, config.driveKi),
+            -integralLimit, integralLimit);
+    }
+
+    return clampInt(q16ToInt(feedforward + proportional + side->integral), -127, 127);
+}
+
+/**
+ * The drive loop. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void driveControl(void *ignore)
+{
+    DriveSide leftSide = {0};
+    DriveSide rightSide = {0};
+    bool wasEnabled = false;
+    unsigned long wakeTime = millis();
+
+    while(1)
+    {
+        // Like the arm, forget what the kernel may have changed while disabled, and start the
+        // velocity loop over
+        bool enabled = isEnabled();
+        if(enabled && !wasEnabled)
+        {
+            motorOutInvalidate(DRIVE_PORTS);
+            leftSide.integral = 0;
+            rightSide.integral = 0;
+        }
+        wasEnabled = enabled;
+
+        uint32_t request = target;
+        int left = UNPACK_LEFT(request);
+        int right = UNPACK_RIGHT(request);
+
+        q16_t leftSpeed;
+        q16_t rightSpeed;
+        odometryGetWheelSpeeds(&leftSpeed, &rightSpeed);
+
+        if(config.driveVelocity && enabled)
+        {
+            left = velocityUpdate(&leftSide, left, leftSpeed);
+            right = velocityUpdate(&rightSide, right, rightSpeed);
+        }
+        else
+        {
+            // The kernel has the motors off while disabled, don't wind up in the meantime
+            leftSide.integral = 0;
+            rightSide.integral = 0;
+        }
+
+        motorOutRequest(LEFT_MOTOR_FRONT, left, MOTOR_PRIORITY_DRIVER);
+        motorOutRequest(LEFT_MOTOR_BACK, left, MOTOR_PRIORITY_DRIVER);
+        motorOutRequest(RIGHT_MOTOR_FRONT, right, MOTOR_PRIORITY_DRIVER);
+        motorOutRequest(RIGHT_MOTOR_BACK, right, MOTOR_PRIORITY_DRIVER);
+        motorOutSetSpeed(MOTOR_PORT_BIT(LEFT_MOTOR_FRONT) | MOTOR_PORT_BIT(LEFT_MOTOR_BACK),
+            q16Div(leftSpeed, Q16(DRIVE_FREE_SPEED)));
+        motorOutSetSpeed(MOTOR_PORT_BIT(RIGHT_MOTOR_FRONT) | MOTOR_PORT_BIT(RIGHT_MOTOR_BACK),
+            q16Div(rightSpeed, Q16(DRIVE_FREE_SPEED)));
+        motorOutFlush(DRIVE_PORTS);
+
+        taskDelayUntil(&wakeTime, DRIVE_PERIOD);
+    }
+}
+
+void driveInit()
+{
+    if(driveTask == NULL)
+    {
+        driveTask = stackTaskCreate("DRIVE", driveControl, DRIVE_STACK_SIZE, NULL,
+            DRIVE_TASK_PRIORITY);
+    }
+}
+
+void driveRequest(int left, int right, unsigned int priority)
+{
+    if(priority >= requestPriority)
+    {
+        requestLeft = clampInt(left, -127, 127);
+        requestRight = clampInt(right, -127, 127);
+        requestPriority = priority;
+    }
+}
+
+void driveFlush()
+{
+    if(requestPriority != 0)
+    {
+        target = PACK(requestLeft, requestRight);
+        requestPriority = 0;
+    }
+}
+
+void driveReset()
+{
+    requestLeft = 0;
+    requestRight = 0;
+    requestPriority = 0;
+    target = PACK(0, 0);
+}
@@ -8,6 +8,23 @@
  */
 
 #include "main.h"
+#include "arm.h"
+#include "bench.h"
+#include "config.h"
+#include "drive.h"
+#include "led.h"
+#include "memory.h"
+#include "menu.h"
+#include "motor.h"
+#include "odometry.h"
+#include "replay.h"
+#include "sensors.h"
+#include "stack.h"
+#include "status.h"
+#include "switches.h"
+#include "telemetry.h"
+#include "timing.h"
+#include "tray.h"
 
 /*
  * Runs pre-initialization code. This function will be started in kernel mode one time while the
@@ -35,5 +52,52 @@ void initializeIO() {
  */
 void initialize()
 {
-    analogCalibrate(ARM_POTENTIOMETER);
+#if BENCH
+    // The benchmark image starts none of the robot's tasks, so they can't preempt it
+    benchInit();
+    return;
+#endif
+
+    // Everything else reads its tuning from the config
+    configLoad();
+
+    // The arm and tray must be all the way down, since this calibrates their potentiometers
+    sensorsAddAnalog(ARM_POTENTIOMETER);
+    sensorsAddAnalog(TRAY_POTENTIOMETER);
+    timingInit();
+    stackMonitorInit();
+
+    // Motors that face the opposite direction from their partner
+    motorOutInit();
+    motorOutSetInverted(RIGHT_MOTOR_FRONT, true);
+    motorOutSetInverted(RIGHT_MOTOR_BACK, true);
+    motorOutSetInverted(RIGHT_ROLLER, true);
+    motorOutSetInverted(RIGHT_ARM, true);
+    motorOutSetInverted(LEFT_ARM, true);
+
+    // The arm and tray controllers do their own slew limiting
+    motorOutSetSlew(LEFT_MOTOR_FRONT, DRIVE_ACCEL, DRIVE_DECEL);
+    motorOutSetSlew(LEFT_MOTOR_BACK, DRIVE_ACCEL, DRIVE_DECEL);
+    motorOutSetSlew(RIGHT_MOTOR_FRONT, DRIVE_ACCEL, DRIVE_DECEL);
+    motorOutSetSlew(RIGHT_MOTOR_BACK, DRIVE_ACCEL, DRIVE_DECEL);
+    motorOutSetSlew(RIGHT_ROLLER, ROLLER_ACCEL, ROLLER_DECEL);
+    motorOutSetSlew(LEFT_ROLLER, ROLLER_ACCEL, ROLLER_DECEL);
+
+    // The tray limit switches engage the tray's hard stops, which the tray task's flushes obey
+    switchesInit();
+
+    sensorsInit();
+    armInit();
+    trayInit();
+    odometryInit();
+    driveInit();
+    ledInit();
+    telemetryInit(stdout);
+    replayInit();
+    configConsoleInit();
+    menuInit();
+    statusInit();
+
+    // Everything has its memory now
+    memoryLock();
 }
@@ -0,0 +1,40 @@
+/** @file joystick.c
+ * @brief Once per tick snapshot of the joystick
+ */
+
+#include "main.h"
+#include "joystick.h"
+
+void joystickUpdate(JoystickState *state, unsigned char joystick)
+{
+    for(unsigned char axis = 1; axis <= 4; axis++)
+    {
+        state->axes[axis - 1] = joystickGetAnalog(joystick, axis);
+    }
+
+    uint16_t buttons = 0;
+    for(unsigned char group = 5; group <= 8; group++)
+    {
+        for(unsigned char button = JOY_DOWN; button <= JOY_RIGHT; button <<= 1)
+        {
+            // Groups 5 and 6 only have up and down
+            if(group <= 6 && (button == JOY_LEFT || button == JOY_RIGHT))
+            {
+                continue;
+            }
+            if(joystickGetDigital(joystick, group, button))
+            {
+                buttons |= JOY_BUTTON(group, button);
+            }
+        }
+    }
+
+    joystickSetButtons(state, buttons);
+}
+
+void joystickSetButtons(JoystickState *state, uint16_t buttons)
+{
+    state->pressed = buttons & ~state->buttons;
+    state->released = state->buttons & ~buttons;
+    state->buttons = buttons;
+}
@@ -0,0 +1,168 @@
+/** @file led.c
+ * @brief WS2812 addressable LED driver
+ *
+ * Every bit of the WS2812 protocol is one 1.25us PWM period. A 0 is a short high pulse and a 1
+ * is a long one, so the frame is expanded into one compare value per bit and DMA feeds them
+ * into the timer on every update event. The DMA transfer is polled for completion rather than
+ * using its interrupt, since the vector table belongs to the kernel.
+ */
+
+#include "main.h"
+#include "led.h"
+
+#define REG32(address) (*(volatile uint32_t *)(address))
+
+// STM32F103 peripheral registers (there are no device headers in a PROS project)
+#define RCC_AHBENR REG32(0x40021014)
+#define RCC_APB2ENR REG32(0x40021018)
+#define RCC_AHBENR_DMA1EN (1 << 0)
+#define RCC_APB2ENR_AFIOEN (1 << 0)
+#define RCC_APB2ENR_IOPEEN (1 << 6)
+#define RCC_APB2ENR_TIM1EN (1 << 11)
+
+#define AFIO_MAPR REG32(0x40010004)
+#define AFIO_MAPR_TIM1_REMAP_MASK (3 << 6)
+#define AFIO_MAPR_TIM1_REMAP_FULL (3 << 6)
+
+#define GPIOE_CRH REG32(0x40011804)
+// PE9 is bits 4-7 of CRH. Alternate function push-pull, 50MHz.
+#define GPIOE_CRH_PE9_MASK (0xF << 4)
+#define GPIOE_CRH_PE9_AF_PP (0xB << 4)
+
+#define TIM1_CR1 REG32(0x40012C00)
+#define TIM1_DIER REG32(0x40012C0C)
+#define TIM1_EGR REG32(0x40012C14)
+#define TIM1_CCMR1 REG32(0x40012C18)
+#define TIM1_CCER REG32(0x40012C20)
+#define TIM1_PSC REG32(0x40012C28)
+#define TIM1_ARR REG32(0x40012C2C)
+#define TIM1_CCR1_ADDRESS 0x40012C34
+#define TIM1_CCR1 REG32(TIM1_CCR1_ADDRESS)
+#define TIM1_BDTR REG32(0x40012C44)
+#define TIM_CR1_CEN (1 << 0)
+#define TIM_CR1_ARPE (1 << 7)
+#define TIM_DIER_UDE (1 << 8)
+#define TIM_EGR_UG (1 << 0)
+#define TIM_CCMR1_OC1PE (1 << 3)
+#define TIM_CCMR1_OC1M_PWM1 (6 << 4)
+#define TIM_CCER_CC1E (1 << 0)
+#define TIM_BDTR_MOE (1 << 15)
+
+// TIM1_UP requests are routed to DMA1 channel 5
+#define DMA1_IFCR REG32(0x40020004)
+#define DMA1_CCR5 REG32(0x40020058)
+#define DMA1_CNDTR5 REG32(0x4002005C)
+#define DMA1_CPAR5 REG32(0x40020060)
+#define DMA1_CMAR5 REG32(0x40020064)
+#define DMA_IFCR_CGIF5 (0xF << 16)
+#define DMA_CCR_EN (1 << 0)
+#define DMA_CCR_DIR_FROM_MEMORY (1 << 4)
+#define DMA_CCR_MINC (1 << 7)
+#define DMA_CCR_PSIZE_16 (1 << 8)
+#define DMA_CCR_MSIZE_8 (0 << 10)
+#define DMA_CCR_PL_HIGH (2 << 12)
+
+// TIM1 runs at 72MHz, so 90 ticks is one 1.25us (800kHz) bit
+#define LED_BIT_PERIOD 90
+// High time of a 0 bit (0.4us) and a 1 bit (0.8us) in timer ticks
+#define LED_BIT_0 29
+#define LED_BIT_1 58
+// Low time needed between frames for the strip to latch, in us
+#define LED_LATCH_TIME 300
+
+#define LED_BITS (LED_COUNT * 24)
+
+// Frame buffer, 3 bytes per pixel in the strip's GRB order
+static uint8_t pixels[LED_COUNT * 3];
+
+// One compare value per bit, plus a trailing 0 so the line idles low once the frame is sent
+static uint8_t bitBuffer[LED_BITS + 1];
+
+// micros() timestamp of when the last frame (plus the latch time) will be done
+static unsigned long frameDoneTime = 0;
+
+void ledInit()
+{
+    RCC_AHBENR |= RCC_AHBENR_DMA1EN;
+    RCC_APB2ENR |= RCC_APB2ENR_AFIOEN | RCC_APB2ENR_IOPEEN | RCC_APB2ENR_TIM1EN;
+
+    // Route TIM1 channel 1 to PE9 (digital port 1) and hand the pin to the timer
+    AFIO_MAPR = (AFIO_MAPR & ~AFIO_MAPR_TIM1_REMAP_MASK) | AFIO_MAPR_TIM1_REMAP_FULL;
+    GPIOE_CRH = (GPIOE_CRH & ~GPIOE_CRH_PE9_MASK) | GPIOE_CRH_PE9_AF_PP;
+
+    // Free running 800kHz PWM, starting out low. The compare value is preloaded so each DMA
+    // write takes effect at the start of the next bit.
+    TIM1_CR1 = 0;
+    TIM1_PSC = 0;
+    TIM1_ARR = LED_BIT_PERIOD - 1;
+    TIM1_CCR1 = 0;
+    TIM1_CCMR1 = TIM_CCMR1_OC1M_PWM1 | TIM_CCMR1_OC1PE;
+    TIM1_CCER = TIM_CCER_CC1E;
+    TIM1_BDTR = TIM_BDTR_MOE;
+    TIM1_DIER = TIM_DIER_UDE;
+    TIM1_EGR = TIM_EGR_UG;
+    TIM1_CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+
+    DMA1_CCR5 = 0;
+    DMA1_CPAR5 = TIM1_CCR1_ADDRESS;
+    DMA1_CMAR5 = (uint32_t)(uintptr_t)bitBuffer;
+
+    ledFill(0, 0, 0);
+}
+
+void ledSetPixel(unsigned int index, uint8_t red, uint8_t green, uint8_t blue)
+{
+    if(index >= LED_COUNT)
+    {
+        return;
+    }
+
+    pixels[index * 3] = green;
+    pixels[index * 3 + 1] = red;
+    pixels[index * 3 + 2] = blue;
+}
+
+void ledFill(uint8_t red, uint8_t green, uint8_t blue)
+{
+    for(unsigned int i = 0; i < LED_COUNT; i++)
+    {
+        ledSetPixel(i, red, green, blue);
+    }
+}
+
+bool ledBusy()
+{
+    return (long)(micros() - frameDoneTime) < 0;
+}
+
+bool ledShow()
+{
+    if(ledBusy() || DMA1_CNDTR5 != 0)
+    {
+        return false;
+    }
+
+    // Expand the frame into one compare value per bit, most significant bit first
+    uint8_t *bit = bitBuffer;
+    for(unsigned int i = 0; i < sizeof(pixels); i++)
+    {
+        for(uint8_t mask = 0x80; mask != 0; mask >>= 1)
+        {
+            *bit++ = (pixels[i] & mask) ? LED_BIT_1 : LED_BIT_0;
+        }
+    }
+    *bit = 0;
+
+    // Restart the DMA channel on the new frame. The transfer count can only be changed while
+    // the channel is disabled.
+    DMA1_CCR5 = 0;
+    DMA1_IFCR = DMA_IFCR_CGIF5;
+    DMA1_CNDTR5 = sizeof(bitBuffer);
+    DMA1_CCR5 = DMA_CCR_DIR_FROM_MEMORY | DMA_CCR_MINC | DMA_CCR_PSIZE_16 | DMA_CCR_MSIZE_8 |
+        DMA_CCR_PL_HIGH | DMA_CCR_EN;
+
+    // 1.25us per bit, rounded up, plus the latch time
+    frameDoneTime = micros() + (sizeof(bitBuffer) * 5 + 3) / 4 + LED_LATCH_TIME;
+
+    return true;
+}
@@ -0,0 +1,107 @@
+/** @file macros.c
+ * @brief Multi-step actions shared by the driver and autonomous
+ */
+
+#include "main.h"
+#include "command.h"
+#include "config.h"
+#include "drive.h"
+#include "macros.h"
+#include "motor.h"
+#include "switches.h"
+#include "tray.h"
+
+// How long the stack is left to settle after the tray is up, in ms
+#define DROP_OFF_SETTLE_TIME 300
+// How long each half of the forward/back bump lasts, in ms
+#define DROP_OFF_BUMP_TIME 200
+// How long to roll out while backing away from the stack, in ms
+#define DROP_OFF_BACK_OUT_TIME 700
+// Longest the tray may take to get up before the macro carries on anyway, in ms
+#define DROP_OFF_TRAY_TIMEOUT 3000
+
+/**
+ * Starts the profiled move up to the stacking position
+ */
+static void trayRaiseInit(Command *command)
+{
+    traySetTarget(config.trayStackPosition);
+}
+
+/**
+ * Done once the tray is up, or if it reached the top switch first
+ */
+static bool trayRaiseIsFinished(Command *command)
+{
+    return trayAtTarget() || commandSwitchPressed(TRAY_LIMIT_UP) ||
+        switchPressed(TRAY_LIMIT_UP);
+}
+
+/**
+ * Holds the tray where it got to if the macro was cancelled on the way up
+ */
+static void trayRaiseEnd(Command *command, bool interrupted)
+{
+    if(interrupted)
+    {
+        trayHold();
+    }
+}
+
+// The tray task does the actual moving, so this only needs the tray to keep anything else
+// from moving it at the same time
+static Command trayRaise =
+{
+    .name = "trayRaise",
+    .init = trayRaiseInit,
+    .isFinished = trayRaiseIsFinished,
+    .end = trayRaiseEnd,
+    .requirements = TRAY_PORTS,
+    .timeout = DROP_OFF_TRAY_TIMEOUT
+};
+
+// The drive and rollers are held still while the tray goes up
+static Command holdStill = COMMAND_POWER("holdStill", DRIVE_PORTS | ROLLER_PORTS, 0, 0);
+static Command *const trayUpChildren[] = {&trayRaise, &holdStill};
+static Command trayUp = COMMAND_RACE("trayUp", trayUpChildren);
+
+// The tray holds its position by itself from here on
+static Command settle = COMMAND_POWER("settle", DRIVE_PORTS | ROLLER_PORTS, 0,
+    DROP_OFF_SETTLE_TIME);
+
+// Bump the robot forward and back
+static Command bumpHold = COMMAND_POWER("bumpHold", ROLLER_PORTS, 0,
+    DROP_OFF_BUMP_TIME);
+static Command bumpForwardDrive = COMMAND_POWER("bumpForwardDrive", DRIVE_PORTS, 60,
+    DROP_OFF_BUMP_TIME);
+static Command *const bumpForwardChildren[] = {&bumpForwardDrive, &bumpHold};
+static Command bumpForward = COMMAND_PARALLEL("bumpForward", bumpForwardChildren);
+static Command bumpBackDrive = COMMAND_POWER("bumpBackDrive", DRIVE_PORTS, -60,
+    DROP_OFF_BUMP_TIME);
+static Command *const bumpBackChildren[] = {&bumpBackDrive, &bumpHold};
+static Command bumpBack = COMMAND_PARALLEL("bumpBack", bumpBackChildren);
+
+/**
+ * Backs up at the tuned backup speed
+ */
+static void backOutDriveExecute(Command *command)
+{
+    driveRequest(-config.backupSpeed, -config.backupSpeed, MOTOR_PRIORITY_MACRO);
+}
+
+// Back up and roll out
+static Command backOutDrive =
+{
+    .name = "backOutDrive",
+    .execute = backOutDriveExecute,
+    .requirements = DRIVE_PORTS,
+    .timeout = DROP_OFF_BACK_OUT_TIME
+};
+static Command backOutRollers = COMMAND_POWER("backOutRollers", ROLLER_PORTS, -80,
+    DROP_OFF_BACK_OUT_TIME);
+static Command *const backOutChildren[] = {&backOutDrive, &backOutRollers};
+static Command backOut = COMMAND_PARALLEL("backOut", backOutChildren);
+
+static Command *const dropOffChildren[] = {&trayUp, &settle, &bumpForward, &bumpBack, &settle,
+    &backOut};
+Command dropOffCommand = COMMAND_SEQUENCE("dropOff", dropOffChildren);
@@ -0,0 +1,185 @@
+/** @file memory.c
+ * @brief Static arena and heap tracking
+ */
+
+#include "main.h"
+#include "memory.h"
+
+#define ALIGN(size) (((size) + MEMORY_ALIGNMENT - 1) & ~(size_t)(MEMORY_ALIGNMENT - 1))
+
+/**
+ * An arena allocation, remembered for memoryPrint()
+ */
+typedef struct
+{
+    const char *owner;
+    size_t size;
+} Allocation;
+
+static uint8_t arena[MEMORY_ARENA_SIZE] __attribute__((aligned(MEMORY_ALIGNMENT)));
+static size_t arenaUsed = 0;
+static bool locked = false;
+
+static Allocation allocations[MEMORY_MAX_ALLOCATIONS];
+static unsigned int allocationCount = 0;
+// Arena allocations that didn't fit or came after memoryLock()
+static unsigned int failedAllocations = 0;
+
+// Heap allocations made (by the kernel) after memoryLock()
+static volatile unsigned int lateHeapAllocations = 0;
+
+// Live heap blocks and their sizes. A slot is free while its block is NULL.
+static void *volatile heapBlocks[MEMORY_HEAP_BLOCKS];
+static size_t heapSizes[MEMORY_HEAP_BLOCKS];
+static volatile size_t heapUsed = 0;
+static size_t heapPeak = 0;
+
+// Size of the heap allocation to paint, see memoryWatchAllocation()
+static volatile size_t watchSize = 0;
+static void *volatile watchedBlock = NULL;
+
+// Linker symbols for the start of the heap and the top of RAM
+extern char _heapbegin;
+extern char _estack;
+
+// The real malloc() and free(), which the linker renames because of the --wrap options in
+// common.mk
+void *__real_malloc(size_t size);
+void __real_free(void *block);
+
+/**
+ * Every call to malloc() in the image comes here first
+ */
+void *__wrap_malloc(size_t size)
+{
+    if(locked)
+    {
+        lateHeapAllocations++;
+    }
+
+    void *block = __real_malloc(size);
+    if(block == NULL)
+    {
+        return NULL;
+    }
+
+    // Claim a slot without locking, since the kernel calls malloc() from any task
+    for(unsigned int i = 0; i < MEMORY_HEAP_BLOCKS; i++)
+    {
+        if(heapBlocks[i] == NULL && __sync_bool_compare_and_swap(&heapBlocks[i], NULL, block))
+        {
+            heapSizes[i] = size;
+            size_t used = __sync_add_and_fetch(&heapUsed, size);
+            if(used > heapPeak)
+            {
+                heapPeak = used;
+            }
+            break;
+        }
+    }
+
+    if(size == watchSize && __sync_bool_compare_and_swap(&watchedBlock, NULL, block))
+    {
+        uint32_t *words = block;
+        for(size_t i = 0; i < size / sizeof(uint32_t); i++)
+        {
+            words[i] = MEMORY_PAINT;
+        }
+    }
+
+    return block;
+}
+
+/**
+ * Every call to free() in the image comes here first
+ */
+void __wrap_free(void *block)
+{
+    if(block == NULL)
+    {
+        return;
+    }
+
+    for(unsigned int i = 0; i < MEMORY_HEAP_BLOCKS; i++)
+    {
+        if(heapBlocks[i] == block)
+        {
+            __sync_sub_and_fetch(&heapUsed, heapSizes[i]);
+            heapBlocks[i] = NULL;
+            break;
+        }
+    }
+    __real_free(block);
+}
+
+void *memoryAlloc(size_t size, const char *owner)
+{
+    size_t alignedSize = ALIGN(size);
+    if(locked || alignedSize > MEMORY_ARENA_SIZE - arenaUsed)
+    {
+        failedAllocations++;
+        return NULL;
+    }
+
+    uint8_t *memory = &arena[arenaUsed];
+    arenaUsed += alignedSize;
+    // The arena is in .bss, so it starts out zeroed and is never reused
+
+    if(allocationCount < MEMORY_MAX_ALLOCATIONS)
+    {
+        allocations[allocationCount].owner = owner;
+        allocations[allocationCount].size = alignedSize;
+        allocationCount++;
+    }
+    return memory;
+}
+
+void memoryWatchAllocation(size_t size)
+{
+    watchedBlock = NULL;
+    __sync_synchronize();
+    watchSize = size;
+}
+
+void *memoryWatchedBlock()
+{
+    void *block = watchedBlock;
+    watchSize = 0;
+    return block;
+}
+
+size_t memoryHeapUsed()
+{
+    return heapUsed;
+}
+
+size_t memoryHeapFree()
+{
+    size_t total = (size_t)(&_estack - &_heapbegin);
+    return heapUsed < total ? total - heapUsed : 0;
+}
+
+void memoryLock()
+{
+    locked = true;
+}
+
+size_t memoryArenaUsed()
+{
+    return arenaUsed;
+}
+
+void memoryPrint(PROS_FILE *stream)
+{
+    fprintf(stream, "arena: %u/%u bytes\r\n", (unsigned int)arenaUsed,
+        (unsigned int)MEMORY_ARENA_SIZE);
+    for(unsigned int i = 0; i < allocationCount; i++)
+    {
+        fprintf(stream, "  %-12s %5u\r\n", allocations[i].owner,
+            (unsigned int)allocations[i].size);
+    }
+    fprintf(stream, "heap: %u bytes used, %u peak, about %u free\r\n", (unsigned int)heapUsed,
+        (unsigned int)heapPeak, (unsigned int)memoryHeapFree());
+    fprintf(stream, "%u failed arena allocations, %u heap allocations after initialize\r\n",
+        failedAllocations, lateHeapAllocations);
+}
@@ -0,0 +1,337 @@
+/** @file menu.c
+ * @brief LCD menu and autonomous selector
+ */
+
+#include "main.h"
+#include "arm.h"
+#include "config.h"
+#include "menu.h"
+#include "path.h"
+#include "replay.h"
+#include "stack.h"
+#include "timing.h"
+
+// For offsetof()
+#include <stddef.h>
+
+/**
+ * The kinds of screen, in the order LEFT and RIGHT step through them
+ */
+typedef enum
+{
+    SCREEN_AUTON,
+    SCREEN_RECORD,
+    SCREEN_FIELD,
+    SCREEN_TIMING,
+    SCREEN_STACK,
+    SCREEN_DIAGNOSTICS
+} ScreenType;
+
+/**
+ * A screen and which field, section or task it shows
+ */
+typedef struct
+{
+    ScreenType type;
+    unsigned int index;
+} Screen;
+
+static TaskHandle menuTask = NULL;
+
+// Position in the flat list of screens, see screenAt()
+static unsigned int current = 0;
+// Whether LEFT and RIGHT are changing the current field instead of moving between screens
+static bool editing = false;
+// Whether the last save from the LCD was refused
+static bool saveFailed = false;
+
+// What is on the LCD now
+static char shown[2][LCD_LINE_SIZE];
+
+/**
+ * The tuning fields that get their own screen. The autonomous selection has a screen of its
+ * own that shows the path name.
+ */
+static bool fieldShown(unsigned int field)
+{
+    return configFields[field].offset != offsetof(Config, autonSelection);
+}
+
+/**
+ * @return How many screens there are. Timing sections and tasks can be added after the menu
+ * starts, so this can grow.
+ */
+static unsigned int screenCount()
+{
+    unsigned int count = 3;
+    for(unsigned int field = 0; field < configFieldCount; field++)
+    {
+        if(fieldShown(field))
+        {
+            count++;
+        }
+    }
+    return count + (unsigned int)timingCount() + stackTaskCount();
+}
+
+/**
+ * @return The screen at a position in the flat list
+ */
+static Screen screenAt(unsigned int position)
+{
+    Screen screen = {SCREEN_AUTON, 0};
+    if(position == 0)
+    {
+        return screen;
+    }
+    if(position == 1)
+    {
+        screen.type = SCREEN_RECORD;
+        return screen;
+    }
+    position -= 2;
+
+    for(unsigned int field = 0; field < configFieldCount; field++)
+    {
+        if(!fieldShown(field))
+        {
+            continue;
+        }
+        if(position == 0)
+        {
+            screen.type = SCREEN_FIELD;
+            screen.index = field;
+            return screen;
+        }
+        position--;
+    }
+
+    if(position < (unsigned int)timingCount())
+    {
+        screen.type = SCREEN_TIMING;
+        screen.index = position;
+        return screen;
+    }
+    position -= (unsigned int)timingCount();
+
+    if(position < stackTaskCount())
+    {
+        screen.type = SCREEN_STACK;
+        screen.index = position;
+        return screen;
+    }
+
+    screen.type = SCREEN_DIAGNOSTICS;
+    return screen;
+}
+
+/**
+ * Saves the config from the LCD and remembers if it was refused
+ */
+static void save()
+{
+    saveFailed = !configSave();
+}
+
+/**
+ * Handles newly pressed buttons
+ */
+static void press(unsigned int buttons)
+{
+    Screen screen = screenAt(current);
+
+    if(screen.type == SCREEN_FIELD && editing)
+    {
+        int32_t step = configFields[screen.index].step;
+        if(buttons & LCD_BTN_LEFT)
+        {
+            configSet(screen.index, configGet(screen.index) - step);
+        }
+        if(buttons & LCD_BTN_RIGHT)
+        {
+            configSet(screen.index, configGet(screen.index) + step);
+        }
+        if(buttons & LCD_BTN_CENTER)
+        {
+            editing = false;
+            save();
+        }
+        return;
+    }
+
+    unsigned int count = screenCount();
+    if(buttons & LCD_BTN_LEFT)
+    {
+        current = current == 0 ? count - 1 : current - 1;
+        saveFailed = false;
+    }
+    if(buttons & LCD_BTN_RIGHT)
+    {
+        current = current + 1 >= count ? 0 : current + 1;
+        saveFailed = false;
+    }
+    if(buttons & LCD_BTN_CENTER)
+    {
+        if(screen.type == SCREEN_AUTON)
+        {
+            // After the paths comes the replay. Set through configSet() so the console can't be
+            // part way through changing it, and so it stays in range.
+            unsigned int field = configFind("autonSelection");
+            configSet(field, (configGet(field) + 1) % (int32_t)(autonPathCount + 1));
+            save();
+        }
+        else if(screen.type == SCREEN_RECORD)
+        {
+            replayArm(replayState() != REPLAY_ARMED);
+        }
+        else if(screen.type == SCREEN_FIELD)
+        {
+            editing = true;
+            saveFailed = false;
+        }
+    }
+}
+
+/**
+ * Formats the current screen as its two lines
+ */
+static void draw(char *top, char *bottom)
+{
+    Screen screen = screenAt(current);
+    switch(screen.type)
+    {
+    case SCREEN_AUTON:
+    {
+        snprintf(top, LCD_LINE_SIZE, saveFailed ? "Auton  not saved" : "Auton");
+        // Out of range selections run the first path, the same as autonomous()
+        unsigned int selection = (unsigned int)config.autonSelection;
+        if(selection == autonPathCount)
+        {
+            snprintf(bottom, LCD_LINE_SIZE, "<replay>");
+        }
+        else if(autonPathCount == 0)
+        {
+            snprintf(bottom, LCD_LINE_SIZE, "no paths");
+        }
+        else
+        {
+            selection = selection < autonPathCount ? selection : 0;
+            snprintf(bottom, LCD_LINE_SIZE, "<%s>", autonPaths[selection]->name);
+        }
+        break;
+    }
+    case SCREEN_RECORD:
+    {
+        static const char *const states[] = {"off", "next run", "recording", "saved", "failed"};
+        ReplayState state = replayState();
+        snprintf(top, LCD_LINE_SIZE, "Record %s", states[state]);
+        if(state == REPLAY_IDLE)
+        {
+            snprintf(bottom, LCD_LINE_SIZE, "CENTER to arm");
+        }
+        else if(state == REPLAY_ARMED)
+        {
+            snprintf(bottom, LCD_LINE_SIZE, "CENTER to cancel");
+        }
+        else
+        {
+            snprintf(bottom, LCD_LINE_SIZE, "%u bytes", (unsigned int)replaySize());
+        }
+        break;
+    }
+    case SCREEN_FIELD:
+    {
+        char value[LCD_LINE_SIZE];
+        configFormat(screen.index, value, sizeof(value));
+        snprintf(top, LCD_LINE_SIZE, "%s", configFields[screen.index].name);
+        if(editing)
+        {
+            snprintf(bottom, LCD_LINE_SIZE, "- %s +", value);
+        }
+        else
+        {
+            snprintf(bottom, LCD_LINE_SIZE, saveFailed ? "%s not saved" : "%s", value);
+        }
+        break;
+    }
+    case SCREEN_TIMING:
+        timingLcd((int)screen.index, top, bottom);
+        break;
+    case SCREEN_STACK:
+        stackLcd(screen.index, top, bottom);
+        break;
+    default:
+        snprintf(top, LCD_LINE_SIZE, "Main %umV", powerLevelMain());
+        snprintf(bottom, LCD_LINE_SIZE, "Bkup %umV A%d", powerLevelBackup(), armGetPosition());
+        break;
+    }
+}
+
+/**
+ * Sends a line to the LCD if it changed
+ */
+static void show(unsigned char line, const char *text)
+{
+    char *old = shown[line - 1];
+    unsigned int i = 0;
+    while(old[i] == text[i] && text[i] != '\0')
+    {
+        i++;
+    }
+    if(old[i] == text[i])
+    {
+        return;
+    }
+
+    snprintf(old, LCD_LINE_SIZE, "%s", text);
+    lcdSetText(LCD_PORT, line, old);
+}
+
+/**
+ * Polls the buttons and redraws the current screen
+ */
+static void menuRun(void *ignore)
+{
+    unsigned int held = 0;
+    unsigned int sinceRedraw = MENU_REDRAW_PERIOD;
+    unsigned long wakeTime = millis();
+    while(true)
+    {
+        unsigned int buttons = lcdReadButtons(LCD_PORT);
+        unsigned int pressed = buttons & ~held;
+        held = buttons;
+
+        if(pressed)
+        {
+            press(pressed);
+            // Show the result of a press right away
+            sinceRedraw = MENU_REDRAW_PERIOD;
+        }
+
+        if(sinceRedraw >= MENU_REDRAW_PERIOD)
+        {
+            char top[LCD_LINE_SIZE];
+            char bottom[LCD_LINE_SIZE];
+            draw(top, bottom);
+            show(1, top);
+            show(2, bottom);
+            sinceRedraw = 0;
+        }
+        sinceRedraw += MENU_POLL_PERIOD;
+
+        taskDelayUntil(&wakeTime, MENU_POLL_PERIOD);
+    }
+}
+
+void menuInit()
+{
+    if(menuTask != NULL)
+    {
+        return;
+    }
+
+    lcdInit(LCD_PORT);
+    lcdClear(LCD_PORT);
+    lcdSetBacklight(LCD_PORT, true);
+    menuTask = stackTaskCreate("MENU", menuRun, MENU_STACK_SIZE, NULL, MENU_PRIORITY);
+}
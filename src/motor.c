@@ -0,0 +1,314 @@
+/** @file motor.c
+ * @brief Buffered motor outputs
+ */
+
+#include "main.h"
+#include "fixed.h"
+#include "interrupts.h"
+#include "motor.h"
+
+/**
+ * State of one motor port. Each field is only written by the task that owns the port.
+ */
+typedef struct
+{
+    // Logical value requested for the next flush
+    int8_t requested;
+    // Logical value currently output, after slew limiting
+    int8_t output;
+    // Slew limits per flush
+    uint8_t accel;
+    uint8_t decel;
+    // Priority of the request made this tick, 0 if there was none
+    uint8_t priority;
+    // Physical value last passed to motorSet()
+    int8_t written;
+    // Whether written matches what the port is actually set to
+    bool valid;
+    bool inverted;
+    // Speed from motorOutSetSpeed(), if the owner gives one
+    bool speedKnown;
+    q16_t speed;
+    // Breaker heat, and millis() when it was last updated. Heat is one word so other tasks can
+    // read it.
+    volatile q16_t heat;
+    unsigned long heatTime;
+} MotorOutput;
+
+static MotorOutput outputs[MOTOR_PORTS];
+
+// Each port has one owner (see main.h), so the mechanisms' masks can't overlap
+_Static_assert((ARM_PORTS & DRIVE_PORTS) == 0 && (ARM_PORTS & TRAY_PORTS) == 0 &&
+    (ARM_PORTS & ROLLER_PORTS) == 0 && (DRIVE_PORTS & TRAY_PORTS) == 0 &&
+    (DRIVE_PORTS & ROLLER_PORTS) == 0 && (TRAY_PORTS & ROLLER_PORTS) == 0,
+    "motor port masks overlap");
+
+// Battery compensation for every port. One word, so it can change while other tasks flush.
+static volatile q16_t scale = Q16_ONE;
+
+// Ports that may not go positive or negative, written by the limit switches (see switches.h)
+static volatile uint16_t stoppedPositive = 0;
+static volatile uint16_t stoppedNegative = 0;
+
+/**
+ * Moves an output one step towards its target within the slew limits
+ *
+ * @param current The current output
+ * @param target The requested output
+ * @param accel The most the output may move away from 0
+ * @param decel The most the output may move towards 0
+ * @return The new output
+ */
+static int slew(int current, int target, int accel, int decel)
+{
+    if(target == current)
+    {
+        return current;
+    }
+
+    // Moving further from 0 in the same direction speeds the motor up
+    if((current >= 0 && target > current) || (current <= 0 && target < current))
+    {
+        return target > current ? clampInt(current + accel, current, target) :
+            clampInt(current - accel, target, current);
+    }
+
+    // Anything else slows it down. Stop at 0 when reversing so the other direction is then
+    // accel limited.
+    int next = target > current ? current + decel : current - decel;
+    if((current > 0 && next < 0) || (current < 0 && next > 0))
+    {
+        next = 0;
+    }
+    return target > current ? clampInt(next, current, target) : clampInt(next, target, current);
+}
+
+/**
+ * @return The estimated current of a port at an output, as a fraction of the stall current
+ */
+static q16_t current(const MotorOutput *output, int value)
+{
+    // Battery compensation makes a logical value a fraction of the nominal voltage
+    q16_t voltage = q16FromInt(value) / 127;
+    q16_t speed = output->speedKnown ? output->speed : q16Mul(voltage, MOTOR_UNKNOWN_LOAD_SPEED);
+    q16_t difference = voltage - speed;
+    return difference < 0 ? -difference : difference;
+}
+
+/**
+ * Adds the heat of the current since the last update and lets some out
+ *
+ * @param value The logical output applied since the last update
+ */
+static void heatUpdate(MotorOutput *output, int value)
+{
+    unsigned long now = millis();
+    unsigned long elapsed = now - output->heatTime;
+    output->heatTime = now;
+
+    q16_t amps = current(output, value);
+    q16_t settled = q16Div(q16Mul(amps, amps), q16Mul(MOTOR_HOLD_CURRENT, MOTOR_HOLD_CURRENT));
+    int64_t change = ((int64_t)settled - output->heat) * (int64_t)elapsed;
+    // Round down, so cooling always makes it the whole way to 0
+    int64_t step = change >= 0 ? change / MOTOR_THERMAL_TIME_CONSTANT :
+        -((-change + MOTOR_THERMAL_TIME_CONSTANT - 1) / MOTOR_THERMAL_TIME_CONSTANT);
+    q16_t heat = q16Saturate(output->heat + step);
+    output->heat = heat > 0 ? heat : 0;
+}
+
+/**
+ * Limits an output to the current the breaker can take at its heat
+ *
+ * @param value The logical output
+ * @return The limited output
+ */
+static int thermalLimit(const MotorOutput *output, int value)
+{
+    q16_t heat = output->heat;
+    if(heat <= MOTOR_HEAT_SOFT)
+    {
+        return value;
+    }
+
+    // From no limit (the most a full reversal can draw) down to the safe current
+    q16_t fraction = q16Clamp(q16Div(heat - MOTOR_HEAT_SOFT, MOTOR_HEAT_HARD - MOTOR_HEAT_SOFT), 0,
+        Q16_ONE);
+    q16_t allowed = q16Lerp(Q16(2.0), MOTOR_SAFE_CURRENT, fraction);
+
+    // The voltages that give that current at the motor's speed
+    q16_t low;
+    q16_t high;
+    if(output->speedKnown)
+    {
+        low = output->speed - allowed;
+        high = output->speed + allowed;
+    }
+    else
+    {
+        high = q16Div(allowed, Q16_ONE - MOTOR_UNKNOWN_LOAD_SPEED);
+        low = -high;
+    }
+    return clampInt(value, clampInt(q16MulInt(low, 127), -127, 127),
+        clampInt(q16MulInt(high, 127), -127, 127));
+}
+
+void motorOutInit()
+{
+    for(unsigned int i = 0; i < MOTOR_PORTS; i++)
+    {
+        outputs[i].requested = 0;
+        outputs[i].output = 0;
+        outputs[i].accel = MOTOR_SLEW_UNLIMITED;
+        outputs[i].decel = MOTOR_SLEW_UNLIMITED;
+        outputs[i].priority = 0;
+        outputs[i].written = 0;
+        outputs[i].valid = false;
+        outputs[i].inverted = false;
+        outputs[i].speedKnown = false;
+        outputs[i].speed = 0;
+        outputs[i].heat = 0;
+        outputs[i].heatTime = millis();
+    }
+    scale = Q16_ONE;
+    stoppedPositive = 0;
+    stoppedNegative = 0;
+}
+
+void motorOutSetInverted(unsigned char port, bool inverted)
+{
+    if(port < 1 || port > MOTOR_PORTS)
+    {
+        return;
+    }
+    outputs[port - 1].inverted = inverted;
+    outputs[port - 1].valid = false;
+}
+
+void motorOutSetSlew(unsigned char port, unsigned int accel, unsigned int decel)
+{
+    if(port < 1 || port > MOTOR_PORTS)
+    {
+        return;
+    }
+    outputs[port - 1].accel = clampInt(accel, 1, MOTOR_SLEW_UNLIMITED);
+    outputs[port - 1].decel = clampInt(decel, 1, MOTOR_SLEW_UNLIMITED);
+}
+
+void motorOutRequest(unsigned char port, int speed, unsigned int priority)
+{
+    if(port < 1 || port > MOTOR_PORTS)
+    {
+        return;
+    }
+
+    MotorOutput *output = &outputs[port - 1];
+    if(priority >= output->priority)
+    {
+        output->requested = clampInt(speed, -127, 127);
+        output->priority = priority;
+    }
+}
+
+void motorOutFlush(uint16_t ports)
+{
+    const q16_t compensation = scale;
+    for(unsigned char i = 0; i < MOTOR_PORTS; i++)
+    {
+        if(!(ports & (1 << i)))
+        {
+            continue;
+        }
+
+        MotorOutput *output = &outputs[i];
+        // The kernel has the motor off while the output isn't valid
+        heatUpdate(output, output->valid ? output->output : 0);
+
+        output->output = slew(output->output, output->requested, output->accel, output->decel);
+        output->output = thermalLimit(output, output->output);
+
+        // Against a hard stop, and the slew limit starts again from 0 once it lets go. The
+        // switch interrupts only change the masks, so they can't change between here and
+        // motorSet() either.
+        uint32_t primask = interruptsMask();
+        if((output->output > 0 && (stoppedPositive & (1 << i))) ||
+            (output->output < 0 && (stoppedNegative & (1 << i))))
+        {
+            output->output = 0;
+        }
+
+        int compensated = clampInt(q16MulInt(compensation, output->output), -127, 127);
+        int8_t physical = output->inverted ? -compensated : compensated;
+        if(!output->valid || physical != output->written)
+        {
+            motorSet(i + 1, physical);
+            output->written = physical;
+            output->valid = true;
+        }
+        interruptsRestore(primask);
+        output->priority = 0;
+    }
+}
+
+void motorOutSetBattery(unsigned int millivolts)
+{
+    if(millivolts < MOTOR_BATTERY_MIN)
+    {
+        scale = Q16_ONE;
+        return;
+    }
+    scale = q16Clamp(q16Div(q16FromInt(MOTOR_NOMINAL_VOLTAGE), q16FromInt(millivolts)),
+        MOTOR_SCALE_MIN, MOTOR_SCALE_MAX);
+}
+
+q16_t motorOutScale()
+{
+    return scale;
+}
+
+void motorOutSetHardStop(uint16_t ports, int direction, bool engaged)
+{
+    volatile uint16_t *stopped = direction > 0 ? &stoppedPositive : &stoppedNegative;
+    *stopped = engaged ? (*stopped | ports) : (*stopped & ~ports);
+}
+
+void motorOutInvalidate(uint16_t ports)
+{
+    for(unsigned int i = 0; i < MOTOR_PORTS; i++)
+    {
+        if(ports & (1 << i))
+        {
+            outputs[i].valid = false;
+            outputs[i].output = 0;
+        }
+    }
+}
+
+void motorOutSetSpeed(uint16_t ports, q16_t speed)
+{
+    for(unsigned char i = 0; i < MOTOR_PORTS; i++)
+    {
+        if(ports & (1 << i))
+        {
+            outputs[i].speed = speed;
+            outputs[i].speedKnown = true;
+        }
+    }
+}
+
+q16_t motorOutHeat(unsigned char port)
+{
+    if(port < 1 || port > MOTOR_PORTS)
+    {
+        return 0;
+    }
+    return outputs[port - 1].heat;
+}
+
+int motorOutGet(unsigned char port)
+{
+    if(port < 1 || port > MOTOR_PORTS)
+    {
+        return 0;
+    }
+    return outputs[port - 1].output;
+}
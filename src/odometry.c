@@ -0,0 +1,187 @@
+/** @file odometry.c
+ * @brief Drive base position tracking
+ */
+
+#include "main.h"
+#include "odometry.h"
+#include "stack.h"
+
+// Converts a difference of wheel travel in inches to a change of heading in degrees
+#define ODOMETRY_DEGREES_PER_INCH Q16(57.29578 / ODOMETRY_TRACK_WIDTH)
+
+// Speed updates per second
+#define ODOMETRY_UPDATES_PER_SECOND (1000 / ODOMETRY_PERIOD)
+
+// Published pose and wheel speeds, guarded by the sequence count: it is odd while they are
+// being written
+static volatile uint32_t poseSequence = 0;
+static volatile Pose publishedPose = {0, 0, 0};
+static volatile q16_t publishedLeftSpeed = 0;
+static volatile q16_t publishedRightSpeed = 0;
+
+// Pose requested by odometrySetPose(), applied by the odometry task
+static volatile bool resetRequested = false;
+static Pose resetPose;
+
+#if !ODOMETRY_USE_IME
+static Encoder leftEncoder = NULL;
+static Encoder rightEncoder = NULL;
+#endif
+static Gyro gyro = NULL;
+
+static TaskHandle odometryTask = NULL;
+
+/**
+ * Reads the cumulative drive encoder counts
+ *
+ * @param left Set to the left count
+ * @param right Set to the right count
+ * @return true if both counts were read
+ */
+static bool readEncoders(int *left, int *right)
+{
+#if ODOMETRY_USE_IME
+    return imeGet(LEFT_DRIVE_IME, left) && imeGet(RIGHT_DRIVE_IME, right);
+#else
+    *left = encoderGet(leftEncoder);
+    *right = encoderGet(rightEncoder);
+    return true;
+#endif
+}
+
+/**
+ * Publishes a new pose and wheel speeds for readers
+ */
+static void publishPose(const Pose *pose, q16_t leftSpeed, q16_t rightSpeed)
+{
+    poseSequence++;
+    __sync_synchronize();
+    publishedPose.x = pose->x;
+    publishedPose.y = pose->y;
+    publishedPose.heading = pose->heading;
+    publishedLeftSpeed = leftSpeed;
+    publishedRightSpeed = rightSpeed;
+    __sync_synchronize();
+    poseSequence++;
+}
+
+/**
+ * The odometry loop. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void odometryUpdate(void *ignore)
+{
+    Pose pose = {0, 0, 0};
+    q16_t leftSpeed = 0;
+    q16_t rightSpeed = 0;
+    int lastLeft = 0;
+    int lastRight = 0;
+    readEncoders(&lastLeft, &lastRight);
+    // The gyro's zero is wherever the heading was when it was last lined up with the pose
+    q16_t gyroOffset = 0;
+
+    unsigned long wakeTime = millis();
+
+    while(1)
+    {
+        int left;
+        int right;
+        if(readEncoders(&left, &right))
+        {
+            q16_t leftTravel = (left - lastLeft) * ODOMETRY_INCHES_PER_TICK;
+            q16_t rightTravel = (right - lastRight) * ODOMETRY_INCHES_PER_TICK;
+            lastLeft = left;
+            lastRight = right;
+
+            leftSpeed += q16Mul(leftTravel * ODOMETRY_UPDATES_PER_SECOND - leftSpeed,
+                ODOMETRY_SPEED_WEIGHT);
+            rightSpeed += q16Mul(rightTravel * ODOMETRY_UPDATES_PER_SECOND - rightSpeed,
+                ODOMETRY_SPEED_WEIGHT);
+
+            q16_t distance = (leftTravel + rightTravel) / 2;
+            q16_t turn = q16Mul(rightTravel - leftTravel, ODOMETRY_DEGREES_PER_INCH);
+
+            // Move along the average heading over the update
+            uint16_t angle = angleFromDegrees(pose.heading + turn / 2);
+            pose.x += q16Mul(distance, q16Cos(angle));
+            pose.y += q16Mul(distance, q16Sin(angle));
+            pose.heading += turn;
+
+            // Pull the heading towards the gyro, which doesn't drift when the wheels slip
+            if(gyro != NULL)
+            {
+                q16_t gyroHeading = q16FromInt(gyroGet(gyro)) + gyroOffset;
+                pose.heading += q16Mul(gyroHeading - pose.heading, ODOMETRY_GYRO_WEIGHT);
+            }
+        }
+
+        if(resetRequested)
+        {
+            pose = resetPose;
+            if(gyro != NULL)
+            {
+                gyroOffset = pose.heading - q16FromInt(gyroGet(gyro));
+            }
+            resetRequested = false;
+        }
+
+        publishPose(&pose, leftSpeed, rightSpeed);
+
+        taskDelayUntil(&wakeTime, ODOMETRY_PERIOD);
+    }
+}
+
+void odometryInit()
+{
+    if(odometryTask != NULL)
+    {
+        return;
+    }
+
+#if ODOMETRY_USE_IME
+    imeInitializeAll();
+#else
+    leftEncoder = encoderInit(LEFT_ENCODER_TOP, LEFT_ENCODER_BOTTOM, false);
+    rightEncoder = encoderInit(RIGHT_ENCODER_TOP, RIGHT_ENCODER_BOTTOM, true);
+#endif
+    gyro = gyroInit(GYRO_PORT, 0);
+
+    odometryTask = stackTaskCreate("ODOMETRY", odometryUpdate, ODOMETRY_STACK_SIZE, NULL,
+        ODOMETRY_TASK_PRIORITY);
+}
+
+void odometryGetPose(Pose *pose)
+{
+    uint32_t sequence;
+    do
+    {
+        // Wait out a write in progress, then make sure no write started while copying
+        sequence = poseSequence;
+        __sync_synchronize();
+        pose->x = publishedPose.x;
+        pose->y = publishedPose.y;
+        pose->heading = publishedPose.heading;
+        __sync_synchronize();
+    } while((sequence & 1) || sequence != poseSequence);
+}
+
+void odometryGetWheelSpeeds(q16_t *left, q16_t *right)
+{
+    uint32_t sequence;
+    do
+    {
+        sequence = poseSequence;
+        __sync_synchronize();
+        *left = publishedLeftSpeed;
+        *right = publishedRightSpeed;
+        __sync_synchronize();
+    } while((sequence & 1) || sequence != poseSequence);
+}
+
+void odometrySetPose(const Pose *pose)
+{
+    resetPose = *pose;
+    __sync_synchronize();
+    resetRequested = true;
+}
@@ -8,6 +8,20 @@
  */
 
 #include "main.h"
+#include "arm.h"
+#include "bench.h"
+#include "command.h"
+#include "config.h"
+#include "curves.h"
+#include "drive.h"
+#include "joystick.h"
+#include "macros.h"
+#include "motor.h"
+#include "replay.h"
+#include "scheduler.h"
+#include "status.h"
+#include "telemetry.h"
+#include "tray.h"
 
 /*
  * Runs the user operator control code. This function will be started in its own task with the
@@ -27,31 +41,6 @@
  * This task should never exit; it should end with some kind of infinite loop, even if empty.
  */
 
-#define JOYSTICK_MASTER 1
-
-// Define motor ports
-#define LEFT_MOTOR_FRONT 5
-#define LEFT_MOTOR_BACK 4
-#define RIGHT_MOTOR_FRONT 2
-#define RIGHT_MOTOR_BACK 3
-#define TRAY 6
-#define RIGHT_ROLLER 7
-#define LEFT_ROLLER 8
-#define RIGHT_ARM 9
-#define LEFT_ARM 10
-
-#define LIGHT_PORT 1
-
-// Voltage for backing up drive motors
-#define BACKUP_SPEED 70
-
-// Contributes every 20ms to a max of 4096
-#define IDEAL_ARM_INCREMENT 30
-
-// Bounds for the arm (with calibration, the lowered state is 0)
-#define ARM_LOWER_BOUND 0
-#define ARM_UPPER_BOUND 4000
-
 /**
  * Convenience function to get the sign of an integer while avoiding branches
  * See https://stackoverflow.com/questions/14579920/fast-sign-of-integer-in-c
@@ -66,249 +55,344 @@ int sign(int x)
 
 /**
  * This function sets the motor power for the right and left side of the robot
- * @param left The left motor voltage. -127 to 127
- * @param right The right motor voltage. -127 to 127
+ * @param left The left motor power (see driveRequest()). -127 to 127
+ * @param right The right motor power. -127 to 127
+ * @param priority The motor request priority, one of the MOTOR_PRIORITY_* values
  */
-void setMotorPower(int left, int right)
+void setMotorPower(int left, int right, unsigned int priority)
 {
-    motorSet(LEFT_MOTOR_FRONT, left);
-    motorSet(LEFT_MOTOR_BACK, left);
-    motorSet(RIGHT_MOTOR_FRONT, right * -1); // Multiply right side by -1 because
-    motorSet(RIGHT_MOTOR_BACK, right * -1); //  the motors are facing the opposite direction
+    driveRequest(left, right, priority);
 }
 
 /**
- * Macro function to (attempt to) drop off the stack of cubes the robot is currently holding
+ * Sets the power for both intake rollers
+ * @param power The roller voltage, positive to intake. -127 to 127
+ * @param priority The motor request priority, one of the MOTOR_PRIORITY_* values
  */
-void dropOffCubes()
+void setRollerPower(int power, unsigned int priority)
 {
-    // Move the tray all the way up
-    for(int i = 127; i >= 30; i -= 2)
-    {
-        motorSet(TRAY, i);
-        delay(20);
-    }
+    motorOutRequest(RIGHT_ROLLER, power, priority);
+    motorOutRequest(LEFT_ROLLER, power, priority);
+}
 
-    motorSet(TRAY, 0);
+// Job rate in milliseconds
+#define CONTROL_PERIOD 20
 
-    delay(2000);
+// Order of the jobs within a tick. Motor conflicts between them are resolved by the motor
+// request priorities instead, and the output job flushes everything at the end of the tick.
+#define INPUT_JOB_PRIORITY 7
+#define MACRO_JOB_PRIORITY 6
+#define DRIVE_JOB_PRIORITY 5
+#define ROLLER_JOB_PRIORITY 4
+#define TRAY_JOB_PRIORITY 3
+#define ARM_JOB_PRIORITY 2
+#define BACKUP_JOB_PRIORITY 1
+#define OUTPUT_JOB_PRIORITY 0
+#define TELEMETRY_JOB_PRIORITY 0
 
-    // Bump the robot forward
-    setMotorPower(60, 60);
-    delay(200);
-    setMotorPower(-60, -60);
-    delay(200);
-    setMotorPower(0, 0);
+// Motor ports written by this task. The arm, drive and tray ports belong to their own tasks.
+#define CONTROL_PORTS (MOTOR_ALL_PORTS & ~(ARM_PORTS | DRIVE_PORTS | TRAY_PORTS))
 
-    delay(2000);
+// Motor port powering the LED strip
+#define LED_POWER_PORT 1
 
-    // Back up and roll out
-    motorSet(RIGHT_ROLLER, 80);
-    motorSet(LEFT_ROLLER, -80);
-    setMotorPower(BACKUP_SPEED * -1, BACKUP_SPEED * -1);
-    delay(700);
-    motorSet(RIGHT_ROLLER, 0);
-    motorSet(LEFT_ROLLER, 0);
-    setMotorPower(0, 0);
-}
+// For the arms
+static int idealLiftPos = 0;
+
+// Joystick snapshot for the current tick
+static JoystickState input;
+
+// Whether the snapshots come from the recording in flash instead of the joystick
+static bool replaying = false;
 
-#define NOP __asm__ __volatile__ ("nop\n\t")
-#define T0H NOP;
-#define T0L NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;NOP;
 
-void attemptLight()
+/**
+ * Takes the joystick snapshot that every other job uses for this tick, and records it if a
+ * recording is running
+ */
+static void inputJob()
 {
-    digitalWrite(LIGHT_PORT, LOW);
-    // Delay 50us (at 90MHz) = 4500 NOP's
-    delayMicroseconds(51);
-    //delay(1000);
-    digitalWrite(LIGHT_PORT, HIGH);
-
-    // Write out 48 0's
-    for(char i = 0; i < 48; i++)
+    if(replaying)
     {
-        digitalWrite(LIGHT_PORT, HIGH);
-        T0H
-        digitalWrite(LIGHT_PORT, LOW);
-        T0L
+        replayNext(&input);
+    }
+    else
+    {
+        joystickUpdate(&input, JOYSTICK_MASTER);
+        replayRecord(&input);
     }
-    digitalWrite(LIGHT_PORT, HIGH);
 }
 
-void operatorControl()
+/**
+ * Gets the drive sticks from the snapshot, shaped by their response curves (see curves.h)
+ *
+ * @param forwardPower Set to the forward power. -127 to 127
+ * @param turningPower Set to the turning power. -90 to 90
+ */
+static void readDriveSticks(int *forwardPower, int *turningPower)
+{
+    // The curves scale the turning power to be less sensitive and have deadbands to avoid
+    // controller drift
+    *forwardPower = curveApply(forwardCurve, joystickAxis(&input, 3));
+    *turningPower = curveApply(turnCurve, joystickAxis(&input, 1));
+}
+
+/**
+ * Runs the macros and the buttons that start and abort them
+ */
+static void macroJob()
 {
     int forwardPower;
     int turningPower;
+    readDriveSticks(&forwardPower, &turningPower);
 
-    // For the arms
-    int idealLiftPos = 0;
+    // The driver can abort the drop off macro with 8 left or by moving the drive stick
+    if(commandIsRunning(&dropOffCommand) && (forwardPower != 0 || turningPower != 0 ||
+        joystickHeld(&input, 8, JOY_LEFT)))
+    {
+        commandCancel(&dropOffCommand);
+    }
 
-    int trayIsCurrentlyFullPower = 0;
+    // Drop off cubes macro
+    if(joystickPressed(&input, 8, JOY_RIGHT))
+    {
+        commandStart(&dropOffCommand);
+    }
 
-    bool debugButtonPressed = false;
+    // While a macro is running it owns its motors, since it requests them at macro priority
+    commandRun();
+}
 
-    while(1)
-    {
-        forwardPower = joystickGetAnalog(JOYSTICK_MASTER, 3);
-        turningPower = joystickGetAnalog(JOYSTICK_MASTER, 1);
+/**
+ * Arcade drive from the left (forward) and right (turning) sticks
+ */
+static void driveJob()
+{
+    int forwardPower;
+    int turningPower;
+    readDriveSticks(&forwardPower, &turningPower);
 
-        // Scale the turning power to be less sensitive
-        turningPower /= 1.4;
+    // Adjust left and right powers
+    int leftPower = forwardPower + turningPower;
+    int rightPower = forwardPower - turningPower;
 
-        // Set min values to avoid controller drift
-        if(turningPower < 15 && turningPower > -15)
-        {
-            turningPower = 0;
-        }
-        if(forwardPower < 15 && forwardPower > -15)
-        {
-            forwardPower = 0;
-        }
+    // Set the drive motors
+    setMotorPower(leftPower, rightPower, MOTOR_PRIORITY_DRIVER);
+}
 
-        // Adjust left and right powers
-        int leftPower = forwardPower + turningPower;
-        int rightPower = forwardPower - turningPower;
+/**
+ * Intake rollers on the 6 buttons
+ */
+static void rollerJob()
+{
+    // Roller motors (the right roller is inverted so they both spin in the same direction)
+    if(joystickHeld(&input, 6, JOY_UP))
+    {
+        setRollerPower(127, MOTOR_PRIORITY_DRIVER);
+    }
+    else if(joystickHeld(&input, 6, JOY_DOWN))
+    {
+        // Make the rollers go slower when releasing cubes for precision moves
+        setRollerPower(-60, MOTOR_PRIORITY_DRIVER);
+    }
+    else
+    {
+        setRollerPower(0, MOTOR_PRIORITY_DRIVER);
+    }
+}
 
-        // Set the drive motors
-        setMotorPower(leftPower, rightPower);
+/**
+ * Tray on the 5 buttons. Holding 5 up raises the tray to the stacking position (fast, then
+ * slowing down for the stack) and 5 down lowers it. Letting go holds it where it is.
+ */
+static void trayJob()
+{
+    // The drop off macro has the tray
+    if(commandUsing(TRAY_PORTS))
+    {
+        return;
+    }
 
-        // Roller motors (make one side negative so they both spin in the same direction)
-        if(joystickGetDigital(JOYSTICK_MASTER, 6, JOY_UP))
-        {
-            motorSet(RIGHT_ROLLER, -127);
-            motorSet(LEFT_ROLLER, 127);
-        }
-        else if(joystickGetDigital(JOYSTICK_MASTER, 6, JOY_DOWN))
-        {
-            // Make the rollers go slower when releasing cubes for precision moves
-            motorSet(RIGHT_ROLLER, 60);
-            motorSet(LEFT_ROLLER, -60);
-        }
-        else
-        {
-            motorSet(RIGHT_ROLLER, 0);
-            motorSet(LEFT_ROLLER, 0);
-        }
+    if(joystickHeld(&input, 5, JOY_UP))
+    {
+        traySetTarget(config.trayStackPosition);
+    }
+    else if(joystickHeld(&input, 5, JOY_DOWN))
+    {
+        traySetTarget(TRAY_LOWER_BOUND);
+    }
+    else if(joystickReleased(&input, 5, JOY_UP) || joystickReleased(&input, 5, JOY_DOWN))
+    {
+        trayHold();
+    }
+}
 
-        // Tray
-        if(joystickGetDigital(JOYSTICK_MASTER, 5, JOY_UP))
-        {
-            // Cycle between full power (for torque) and 40 power (for slowness)
-            if(trayIsCurrentlyFullPower == 0)
-            {
-                motorSet(TRAY, 127);
-                trayIsCurrentlyFullPower = 1;
-            }
-            else
-            {
-                motorSet(TRAY, 40);
-                trayIsCurrentlyFullPower++;
-                if(trayIsCurrentlyFullPower > 3)
-                {
-                    trayIsCurrentlyFullPower = 0;
-                }
-            }
-        }
-        else if(joystickGetDigital(JOYSTICK_MASTER, 5, JOY_DOWN))
+/**
+ * Intake arm setpoint and feedforward learning on the 7 buttons
+ */
+static void armJob()
+{
+    // Intake arm
+    //TODO use manual override in case new algorithm fails miserably during competition
+    /*if(joystickHeld(&input, 7, JOY_UP))
+    {
+        motorSet(RIGHT_ARM, -127);
+        motorSet(LEFT_ARM, -127);
+    }
+    else if(joystickHeld(&input, 7, JOY_DOWN))
+    {
+        motorSet(RIGHT_ARM, 127);
+        motorSet(LEFT_ARM, 127);
+    }
+    else
+    {
+        motorSet(RIGHT_ARM, 0);
+        motorSet(LEFT_ARM, 0);
+    }*/
+
+    // New algorithm designed to keep (mostly) constant position
+    // It works by using the buttons to adjust ideal position instead of voltage
+    // and trying to automatically set the voltage to reach (and stay at) the ideal position
+    // TODO set proper bounds based on sensor testing
+    if(joystickHeld(&input, 7, JOY_UP))
+    {
+        if((idealLiftPos + config.armIncrement) > config.armUpperBound)
         {
-            motorSet(TRAY, -127);
+            idealLiftPos = config.armUpperBound;
         }
         else
         {
-            motorSet(TRAY, 0);
+            idealLiftPos += config.armIncrement;
         }
-
-        // Intake arm
-        //TODO use manual override in case new algorithm fails miserably during competition
-        /*if(joystickGetDigital(JOYSTICK_MASTER, 7, JOY_UP))
-        {
-            motorSet(RIGHT_ARM, -127);
-            motorSet(LEFT_ARM, -127);
-        }
-        else if(joystickGetDigital(JOYSTICK_MASTER, 7, JOY_DOWN))
+    }
+    else if(joystickHeld(&input, 7, JOY_DOWN))
+    {
+        if((idealLiftPos - config.armIncrement) < ARM_LOWER_BOUND)
         {
-            motorSet(RIGHT_ARM, 127);
-            motorSet(LEFT_ARM, 127);
+            idealLiftPos = ARM_LOWER_BOUND;
         }
         else
         {
-            motorSet(RIGHT_ARM, 0);
-            motorSet(LEFT_ARM, 0);
-        }*/
-
-        // New algorithm designed to keep (mostly) constant position
-        // It works by using the buttons to adjust ideal position instead of voltage
-        // and trying to automatically set the voltage to reach (and stay at) the ideal position
-        // TODO set proper bounds based on sensor testing
-        if(joystickGetDigital(JOYSTICK_MASTER, 7, JOY_UP))
-        {
-            if((idealLiftPos + IDEAL_ARM_INCREMENT) > ARM_UPPER_BOUND)
-            {
-                idealLiftPos = ARM_UPPER_BOUND;
-            }
-            else
-            {
-                idealLiftPos += IDEAL_ARM_INCREMENT;
-            }
-        }
-        else if(joystickGetDigital(JOYSTICK_MASTER, 7, JOY_DOWN))
-        {
-            if((idealLiftPos - IDEAL_ARM_INCREMENT) < ARM_LOWER_BOUND)
-            {
-                idealLiftPos = ARM_LOWER_BOUND;
-            }
-            else
-            {
-                idealLiftPos -= IDEAL_ARM_INCREMENT;
-            }
+            idealLiftPos -= config.armIncrement;
         }
+    }
 
-        // Get difference in (angular) position for proportional applied voltage
-        int currentPos = analogReadCalibrated(ARM_POTENTIOMETER);
-        int proportional = (idealLiftPos - currentPos) * -0.1;
-        // Set the arm motors
-        motorSet(RIGHT_ARM, proportional);
-        motorSet(LEFT_ARM, proportional);
+    // Reset on the left key
+    if(joystickHeld(&input, 7, JOY_LEFT))
+    {
+        idealLiftPos = ARM_LOWER_BOUND;
+    }
 
-        // Reset on the left key
-        if(joystickGetDigital(JOYSTICK_MASTER, 7, JOY_LEFT))
-        {
-            idealLiftPos = ARM_LOWER_BOUND;
-        }
+    // The arm task does the actual position control
+    armSetTarget(idealLiftPos);
 
-        // Back up and turn rollers out
-        if(joystickGetDigital(JOYSTICK_MASTER, 8, JOY_DOWN))
-        {
-            motorSet(RIGHT_ROLLER, 80);
-            motorSet(LEFT_ROLLER, -80);
+    // 7 right while holding 7 left learns the gravity feedforward table, and moving the arm
+    // stops it
+    if(joystickHeld(&input, 7, JOY_LEFT) && joystickPressed(&input, 7, JOY_RIGHT))
+    {
+        armLearnStart();
+    }
+    else if(armLearning() && (joystickHeld(&input, 7, JOY_UP) ||
+        joystickHeld(&input, 7, JOY_DOWN)))
+    {
+        armLearnCancel();
+    }
+}
+
+/**
+ * Backing up on 8 down, the LED test on 8 up and the timing, memory and stack report on
+ * 7 right
+ */
+static void backupJob()
+{
+    if(joystickPressed(&input, 7, JOY_RIGHT) && !joystickHeld(&input, 7, JOY_LEFT))
+    {
+        statusRequestReport();
+    }
 
+    // Back up and turn rollers out, overriding the drive and roller buttons
+    if(joystickHeld(&input, 8, JOY_DOWN))
+    {
+        setRollerPower(-80, MOTOR_PRIORITY_OVERRIDE);
+        setMotorPower(-config.backupSpeed, -config.backupSpeed, MOTOR_PRIORITY_OVERRIDE);
+    }
 
-            motorSet(LEFT_MOTOR_FRONT, BACKUP_SPEED * -1);
-            motorSet(LEFT_MOTOR_BACK, BACKUP_SPEED * -1);
-            motorSet(RIGHT_MOTOR_FRONT, BACKUP_SPEED);
-            motorSet(RIGHT_MOTOR_BACK, BACKUP_SPEED);
-        }
+    if(joystickPressed(&input, 8, JOY_UP))
+    {
+        motorOutRequest(LED_POWER_PORT, 127, MOTOR_PRIORITY_DRIVER);
+    }
 
-        // Drop off cubes macro
-        if(joystickGetDigital(JOYSTICK_MASTER, 8, JOY_RIGHT))
-        {
-            dropOffCubes();
-        }
+    if(joystickReleased(&input, 8, JOY_UP))
+    {
+        motorOutRequest(LED_POWER_PORT, 0, MOTOR_PRIORITY_DRIVER);
+        statusRequestLedsOff();
+    }
+}
 
-        if(!debugButtonPressed && joystickGetDigital(JOYSTICK_MASTER, 8, JOY_UP))
-        {
-            motorSet(1, 127);
-            debugButtonPressed = true;
-        }
+/**
+ * Writes every motor that changed this tick
+ */
+static void outputJob()
+{
+    driveFlush();
+    motorOutFlush(CONTROL_PORTS);
+}
 
-        if(debugButtonPressed && !joystickGetDigital(JOYSTICK_MASTER, 8, JOY_UP))
-        {
-            motorSet(1, 0);
-            debugButtonPressed = false;
+/**
+ * Logs the outputs of this tick
+ */
+static void telemetryJob()
+{
+    telemetrySample();
+}
 
-            attemptLight();
-        }
+/**
+ * Runs the control jobs. Never returns.
+ */
+static void runControl()
+{
+    // The task may have been restarted mid-match, so reset everything left over from last time
+    commandCancelAll();
+    idealLiftPos = 0;
+    input = (JoystickState) {0};
+    armSetTarget(idealLiftPos);
+
+    // The kernel stops the motors while disabled, so the last written values can't be trusted
+    motorOutInvalidate(CONTROL_PORTS);
+    driveReset();
+
+    schedulerReset();
+    schedulerAdd("input", inputJob, CONTROL_PERIOD, INPUT_JOB_PRIORITY);
+    schedulerAdd("macro", macroJob, CONTROL_PERIOD, MACRO_JOB_PRIORITY);
+    schedulerAdd("drive", driveJob, CONTROL_PERIOD, DRIVE_JOB_PRIORITY);
+    schedulerAdd("rollers", rollerJob, CONTROL_PERIOD, ROLLER_JOB_PRIORITY);
+    schedulerAdd("tray", trayJob, CONTROL_PERIOD, TRAY_JOB_PRIORITY);
+    schedulerAdd("arm", armJob, CONTROL_PERIOD, ARM_JOB_PRIORITY);
+    schedulerAdd("backup", backupJob, CONTROL_PERIOD, BACKUP_JOB_PRIORITY);
+    schedulerAdd("output", outputJob, CONTROL_PERIOD, OUTPUT_JOB_PRIORITY);
+    schedulerAdd("telemetry", telemetryJob, CONTROL_PERIOD, TELEMETRY_JOB_PRIORITY);
+
+    schedulerRun();
+}
+
+void operatorControl()
+{
+#if BENCH
+    // The benchmark image measures the API instead of running the robot
+    benchRun();
+#endif
+
+    replaying = false;
+    replayRecordStart(CONTROL_PERIOD);
+    runControl();
+}
 
-        delay(20);
+void operatorReplay()
+{
+    if(!replayStart(CONTROL_PERIOD))
+    {
+        return;
     }
-}
\ No newline at end of file
+    replaying = true;
+    runControl();
+}
@@ -0,0 +1,167 @@
+/** @file path.c
+ * @brief Autonomous path following
+ */
+
+#include "main.h"
+#include "config.h"
+#include "drive.h"
+#include "motor.h"
+#include "odometry.h"
+#include "path.h"
+
+// Inches/s of each wheel per degree/s of turning in place, half the track width times pi / 180
+#define PATH_WHEEL_PER_DEGREE (ODOMETRY_TRACK_WIDTH / 2 * 3.14159265 / 180)
+
+// Motor power per inch/s, inch/s^2 and inch of error while driving. The velocity term is the
+// drive's own, what it takes to hold a speed on the ground.
+#define PATH_DRIVE_KV DRIVE_KV
+#define PATH_DRIVE_KA Q16(0.9)
+#define PATH_DRIVE_KP Q16(8.0)
+// Motor power per degree of heading error while driving straight
+#define PATH_HEADING_KP Q16(2.0)
+
+// Motor power per degree/s, degree/s^2 and degree of error while turning
+#define PATH_TURN_KV Q16(127.0 / DRIVE_FREE_SPEED * PATH_WHEEL_PER_DEGREE)
+#define PATH_TURN_KA Q16(0.1)
+#define PATH_TURN_KP Q16(2.5)
+
+// Requests per inch/s and per degree/s in the drive's velocity mode, where a request is a
+// fraction of DRIVE_MAX_SPEED. The error gains above are used as they are, as fractions of it.
+#define PATH_DRIVE_SPEED Q16(127.0 / DRIVE_MAX_SPEED)
+#define PATH_TURN_SPEED Q16(127.0 / DRIVE_MAX_SPEED * PATH_WHEEL_PER_DEGREE)
+
+// How close the robot has to be to the end of a leg, in inches and degrees
+#define PATH_DRIVE_TOLERANCE Q16(0.5)
+#define PATH_TURN_TOLERANCE Q16(1.5)
+
+// How long to keep correcting once a profile ends before giving up on the tolerance, in ms
+#define PATH_SETTLE_TIMEOUT 500
+
+// Time for the odometry task to pick up the path's starting pose before the first leg, in ms
+#define PATH_START_DELAY (2 * ODOMETRY_PERIOD)
+
+// The command's locals are the index of the current leg and the millis() time it started
+#define CURRENT_LEG locals[0]
+#define LEG_START locals[1]
+
+/**
+ * Requests the drive outputs
+ *
+ * @param left The left side power. Clamped to -127 to 127
+ * @param right The right side power. Clamped to -127 to 127
+ */
+static void driveOutput(int left, int right)
+{
+    driveRequest(left, right, MOTOR_PRIORITY_MACRO);
+}
+
+/**
+ * The feedforward of a profile point. In the drive's velocity mode the drive's own loop finds
+ * the voltage, so the request is just the speed and the voltage gains don't apply.
+ *
+ * @param point The profile point
+ * @param kv Voltage per unit/s
+ * @param ka Voltage per unit/s^2
+ * @param speed Velocity mode request per unit/s
+ * @return The feedforward request
+ */
+static q16_t feedforward(const ProfilePoint *point, q16_t kv, q16_t ka, q16_t speed)
+{
+    if(config.driveVelocity)
+    {
+        return q16Mul(point->velocity, speed);
+    }
+    return q16Mul(point->velocity, kv) + q16Mul(point->acceleration, ka);
+}
+
+/**
+ * Follows one leg for a tick
+ *
+ * @param leg The leg to follow
+ * @param elapsed Time since the leg started in ms
+ * @return true if the leg is done, in which case nothing was requested
+ */
+static bool followLeg(const PathLeg *leg, unsigned long elapsed)
+{
+    unsigned long step = elapsed / PATH_PERIOD;
+    bool profileDone = step >= leg->length;
+    const ProfilePoint *point = &leg->profile[profileDone ? leg->length - 1u : step];
+
+    Pose pose;
+    odometryGetPose(&pose);
+
+    q16_t error;
+    q16_t forward = 0;
+    q16_t turn;
+    bool inTolerance;
+    if(leg->type == PATH_LEG_DRIVE)
+    {
+        // Distance along the leg, which ignores any sideways drift
+        uint16_t angle = angleFromDegrees(leg->heading);
+        q16_t travelled = q16Mul(pose.x - leg->startX, q16Cos(angle)) +
+            q16Mul(pose.y - leg->startY, q16Sin(angle));
+        error = point->position - travelled;
+        forward = feedforward(point, PATH_DRIVE_KV, PATH_DRIVE_KA, PATH_DRIVE_SPEED) +
+            q16Mul(error, PATH_DRIVE_KP);
+        turn = q16Mul(leg->heading - pose.heading, PATH_HEADING_KP);
+        inTolerance = error > -PATH_DRIVE_TOLERANCE && error < PATH_DRIVE_TOLERANCE;
+    }
+    else
+    {
+        error = leg->heading + point->position - pose.heading;
+        turn = feedforward(point, PATH_TURN_KV, PATH_TURN_KA, PATH_TURN_SPEED) +
+            q16Mul(error, PATH_TURN_KP);
+        inTolerance = error > -PATH_TURN_TOLERANCE && error < PATH_TURN_TOLERANCE;
+    }
+
+    unsigned long settleEnd = (unsigned long)leg->length * PATH_PERIOD + PATH_SETTLE_TIMEOUT;
+    if(profileDone && (inTolerance || elapsed >= settleEnd))
+    {
+        return true;
+    }
+
+    // Positive turns are counterclockwise
+    driveOutput(q16ToInt(forward - turn), q16ToInt(forward + turn));
+    return false;
+}
+
+void pathCommandInit(Command *command)
+{
+    const Path *path = command->data;
+    odometrySetPose(&path->start);
+    command->CURRENT_LEG = 0;
+    command->LEG_START = (int)(millis() + PATH_START_DELAY);
+}
+
+void pathCommandExecute(Command *command)
+{
+    const Path *path = command->data;
+    int elapsed = (int)millis() - command->LEG_START;
+
+    // Hold still until the odometry has the new pose
+    if(elapsed < 0)
+    {
+        driveOutput(0, 0);
+        return;
+    }
+
+    while(command->CURRENT_LEG < path->legCount &&
+        followLeg(&path->legs[command->CURRENT_LEG], (unsigned long)elapsed))
+    {
+        // Start the next leg straight away so the drive doesn't stop for a tick in between
+        command->CURRENT_LEG++;
+        command->LEG_START = (int)millis();
+        elapsed = 0;
+    }
+}
+
+bool pathCommandIsFinished(Command *command)
+{
+    const Path *path = command->data;
+    return command->CURRENT_LEG >= path->legCount;
+}
+
+void pathCommandEnd(Command *command, bool interrupted)
+{
+    driveOutput(0, 0);
+}
@@ -0,0 +1,915 @@
+/** @file paths.c
+ * @brief Autonomous paths and motion profiles
+ *
+ * Generated by tools/genpaths.py, do not edit by hand.
+ */
+
+#include "main.h"
+#include "path.h"
+
+// rowPath leg 0: drive from (0.0, 0.0) at 0.0 degrees, 3.21s
+static const ProfilePoint rowPathLeg0[321] =
+{
+    {10, 1966, 196608},
+    {49, 5898, 393216},
+    {138, 11796, 589824},
+    {295, 19661, 786432},
+    {541, 29491, 983040},
+    {895, 41288, 1179648},
+    {1376, 55050, 1376256},
+    {2005, 70779, 1572864},
+    {2802, 88474, 1769472},
+    {3785, 108134, 1966080},
+    {4974, 129761, 2162688},
+    {6390, 153354, 2359296},
+    {8041, 176947, 2359296},
+    {9929, 200540, 2359296},
+    {12052, 224133, 2359296},
+    {14412, 247726, 2359296},
+    {17007, 271319, 2359296},
+    {19838, 294912, 2359296},
+    {22905, 318505, 2359296},
+    {26208, 342098, 2359296},
+    {29747, 365691, 2359296},
+    {33522, 389284, 2359296},
+    {37533, 412877, 2359296},
+    {41780, 436470, 2359296},
+    {46262, 460063, 2359296},
+    {50981, 483656, 2359296},
+    {55936, 507249, 2359296},
+    {61126, 530842, 2359296},
+    {66552, 554435, 2359296},
+    {72215, 578028, 2359296},
+    {78113, 601620, 2359296},
+    {84247, 625213, 2359296},
+    {90618, 648806, 2359296},
+    {97224, 672399, 2359296},
+    {104066, 695992, 2359296},
+    {111144, 719585, 2359296},
+    {118458, 743178, 2359296},
+    {126007, 766771, 2359296},
+    {133793, 790364, 2359296},
+    {141815, 813957, 2359296},
+    {150072, 837550, 2359296},
+    {158563, 860488, 2293760},
+    {167272, 881459, 2097152},
+    {176182, 900465, 1900544},
+    {185272, 917504, 1703936},
+    {194523, 932577, 1507328},
+    {203914, 945684, 1310720},
+    {213427, 956826, 1114112},
+    {223041, 966001, 917504},
+    {232737, 973210, 720896},
+    {242495, 978452, 524288},
+    {252296, 981729, 327680},
+    {262120, 983040, 131072},
+    {271951, 983040, 0},
+    {281781, 983040, 0},
+    {291612, 983040, 0},
+    {301442, 983040, 0},
+    {311273, 983040, 0},
+    {321103, 983040, 0},
+    {330934, 983040, 0},
+    {340764, 983040, 0},
+    {350595, 983040, 0},
+    {360425, 983040, 0},
+    {370256, 983040, 0},
+    {380086, 983040, 0},
+    {389917, 983040, 0},
+    {399747, 983040, 0},
+    {409578, 983040, 0},
+    {419408, 983040, 0},
+    {429239, 983040, 0},
+    {439069, 983040, 0},
+    {448900, 983040, 0},
+    {458730, 983040, 0},
+    {468561, 983040, 0},
+    {478391, 983040, 0},
+    {488222, 983040, 0},
+    {498052, 983040, 0},
+    {507883, 983040, 0},
+    {517713, 983040, 0},
+    {527544, 983040, 0},
+    {537374, 983040, 0},
+    {547205, 983040, 0},
+    {557035, 983040, 0},
+    {566866, 983040, 0},
+    {576696, 983040, 0},
+    {586527, 983040, 0},
+    {596357, 983040, 0},
+    {606188, 983040, 0},
+    {616018, 983040, 0},
+    {625849, 983040, 0},
+    {635679, 983040, 0},
+    {645510, 983040, 0},
+    {655340, 983040, 0},
+    {665171, 983040, 0},
+    {675001, 983040, 0},
+    {684832, 983040, 0},
+    {694662, 983040, 0},
+    {704493, 983040, 0},
+    {714323, 983040, 0},
+    {724154, 983040, 0},
+    {733984, 983040, 0},
+    {743815, 983040, 0},
+    {753645, 983040, 0},
+    {763476, 983040, 0},
+    {773306, 983040, 0},
+    {783137, 983040, 0},
+    {792967, 983040, 0},
+    {802798, 983040, 0},
+    {812628, 983040, 0},
+    {822459, 983040, 0},
+    {832289, 983040, 0},
+    {842120, 983040, 0},
+    {851950, 983040, 0},
+    {861781, 983040, 0},
+    {871611, 983040, 0},
+    {881442, 983040, 0},
+    {891272, 983040, 0},
+    {901103, 983040, 0},
+    {910933, 983040, 0},
+    {920764, 983040, 0},
+    {930594, 983040, 0},
+    {940425, 983040, 0},
+    {950255, 983040, 0},
+    {960086, 983040, 0},
+    {969916, 983040, 0},
+    {979747, 983040, 0},
+    {989577, 983040, 0},
+    {999408, 983040, 0},
+    {1009238, 983040, 0},
+    {1019069, 983040, 0},
+    {1028899, 983040, 0},
+    {1038730, 983040, 0},
+    {1048560, 983040, 0},
+    {1058391, 983040, 0},
+    {1068221, 983040, 0},
+    {1078052, 983040, 0},
+    {1087882, 983040, 0},
+    {1097713, 983040, 0},
+    {1107543, 983040, 0},
+    {1117374, 983040, 0},
+    {1127204, 983040, 0},
+    {1137035, 983040, 0},
+    {1146865, 983040, 0},
+    {1156696, 983040, 0},
+    {1166526, 983040, 0},
+    {1176357, 983040, 0},
+    {1186187, 983040, 0},
+    {1196018, 983040, 0},
+    {1205848, 983040, 0},
+    {1215679, 983040, 0},
+    {1225509, 983040, 0},
+    {1235340, 983040, 0},
+    {1245170, 983040, 0},
+    {1255001, 983040, 0},
+    {1264831, 983040, 0},
+    {1274662, 983040, 0},
+    {1284492, 983040, 0},
+    {1294323, 983040, 0},
+    {1304153, 983040, 0},
+    {1313984, 983040, 0},
+    {1323814, 983040, 0},
+    {1333645, 983040, 0},
+    {1343475, 983040, 0},
+    {1353306, 983040, 0},
+    {1363136, 983040, 0},
+    {1372967, 983040, 0},
+    {1382797, 983040, 0},
+    {1392628, 983040, 0},
+    {1402458, 983040, 0},
+    {1412289, 983040, 0},
+    {1422119, 983040, 0},
+    {1431950, 983040, 0},
+    {1441780, 983040, 0},
+    {1451611, 983040, 0},
+    {1461441, 983040, 0},
+    {1471272, 983040, 0},
+    {1481102, 983040, 0},
+    {1490933, 983040, 0},
+    {1500763, 983040, 0},
+    {1510594, 983040, 0},
+    {1520424, 983040, 0},
+    {1530255, 983040, 0},
+    {1540085, 983040, 0},
+    {1549916, 983040, 0},
+    {1559746, 983040, 0},
+    {1569577, 983040, 0},
+    {1579407, 983040, 0},
+    {1589238, 983040, 0},
+    {1599068, 983040, 0},
+    {1608899, 983040, 0},
+    {1618729, 983040, 0},
+    {1628560, 983040, 0},
+    {1638390, 983040, 0},
+    {1648221, 983040, 0},
+    {1658051, 983040, 0},
+    {1667882, 983040, 0},
+    {1677712, 983040, 0},
+    {1687543, 983040, 0},
+    {1697373, 983040, 0},
+    {1707204, 983040, 0},
+    {1717034, 983040, 0},
+    {1726865, 983040, 0},
+    {1736695, 983040, 0},
+    {1746526, 983040, 0},
+    {1756356, 983040, 0},
+    {1766187, 983040, 0},
+    {1776017, 983040, 0},
+    {1785848, 983040, 0},
+    {1795678, 983040, 0},
+    {1805509, 983040, 0},
+    {1815339, 983040, 0},
+    {1825170, 983040, 0},
+    {1835000, 983040, 0},
+    {1844831, 983040, 0},
+    {1854661, 983040, 0},
+    {1864492, 983040, 0},
+    {1874322, 983040, 0},
+    {1884153, 983040, 0},
+    {1893983, 983040, 0},
+    {1903814, 983040, 0},
+    {1913644, 983040, 0},
+    {1923475, 983040, 0},
+    {1933305, 983040, 0},
+    {1943136, 983040, 0},
+    {1952966, 983040, 0},
+    {1962797, 983040, 0},
+    {1972627, 983040, 0},
+    {1982458, 983040, 0},
+    {1992288, 983040, 0},
+    {2002119, 983040, 0},
+    {2011949, 983040, 0},
+    {2021780, 983040, 0},
+    {2031610, 983040, 0},
+    {2041441, 983040, 0},
+    {2051271, 983040, 0},
+    {2061102, 983040, 0},
+    {2070932, 983040, 0},
+    {2080763, 983040, 0},
+    {2090593, 983040, 0},
+    {2100424, 983040, 0},
+    {2110254, 983040, 0},
+    {2120085, 983040, 0},
+    {2129915, 983040, 0},
+    {2139746, 983040, 0},
+    {2149576, 983040, 0},
+    {2159407, 983040, 0},
+    {2169237, 983040, 0},
+    {2179068, 983040, 0},
+    {2188898, 983040, 0},
+    {2198729, 983040, 0},
+    {2208559, 983040, 0},
+    {2218390, 983040, 0},
+    {2228220, 983040, 0},
+    {2238051, 983040, 0},
+    {2247881, 983040, 0},
+    {2257712, 983040, 0},
+    {2267542, 983040, 0},
+    {2277373, 983040, 0},
+    {2287203, 983040, 0},
+    {2297034, 983040, 0},
+    {2306864, 983040, 0},
+    {2316695, 983040, 0},
+    {2326525, 983040, 0},
+    {2336356, 983040, 0},
+    {2346186, 983040, 0},
+    {2356017, 983040, 0},
+    {2365844, 982385, -65536},
+    {2375655, 979763, -262144},
+    {2385429, 975176, -458752},
+    {2395148, 968622, -655360},
+    {2404792, 960102, -851968},
+    {2414341, 949617, -1048576},
+    {2423775, 937165, -1245184},
+    {2433075, 922747, -1441792},
+    {2442220, 906363, -1638400},
+    {2451192, 888013, -1835008},
+    {2459971, 867697, -2031616},
+    {2468536, 845414, -2228224},
+    {2476873, 821821, -2359296},
+    {2484973, 798228, -2359296},
+    {2492837, 774636, -2359296},
+    {2500466, 751043, -2359296},
+    {2507858, 727450, -2359296},
+    {2515015, 703857, -2359296},
+    {2521936, 680264, -2359296},
+    {2528620, 656671, -2359296},
+    {2535069, 633078, -2359296},
+    {2541282, 609485, -2359296},
+    {2547259, 585892, -2359296},
+    {2553000, 562299, -2359296},
+    {2558505, 538706, -2359296},
+    {2563774, 515113, -2359296},
+    {2568808, 491520, -2359296},
+    {2573605, 467927, -2359296},
+    {2578166, 444334, -2359296},
+    {2582492, 420741, -2359296},
+    {2586581, 397148, -2359296},
+    {2590435, 373555, -2359296},
+    {2594052, 349962, -2359296},
+    {2597434, 326369, -2359296},
+    {2600580, 302776, -2359296},
+    {2603490, 279183, -2359296},
+    {2606163, 255590, -2359296},
+    {2608601, 231997, -2359296},
+    {2610803, 208404, -2359296},
+    {2612770, 184812, -2359296},
+    {2614500, 161219, -2359296},
+    {2615994, 137626, -2359296},
+    {2617259, 115343, -2228224},
+    {2618311, 95027, -2031616},
+    {2619169, 76677, -1835008},
+    {2619854, 60293, -1638400},
+    {2620385, 45875, -1441792},
+    {2620781, 33423, -1245184},
+    {2621063, 22938, -1048576},
+    {2621250, 14418, -851968},
+    {2621361, 7864, -655360},
+    {2621417, 3277, -458752},
+    {2621437, 655, -262144},
+    {2621440, 0, -65536},
+    {2621440, 0, 0},
+};
+
+// rowPath leg 1: drive from (40.0, 0.0) at 0.0 degrees, 2.14s
+static const ProfilePoint rowPathLeg1[214] =
+{
+    {-10, -1966, -196608},
+    {-49, -5898, -393216},
+    {-138, -11796, -589824},
+    {-295, -19661, -786432},
+    {-541, -29491, -983040},
+    {-895, -41288, -1179648},
+    {-1376, -55050, -1376256},
+    {-2005, -70779, -1572864},
+    {-2802, -88474, -1769472},
+    {-3785, -108134, -1966080},
+    {-4974, -129761, -2162688},
+    {-6390, -153354, -2359296},
+    {-8041, -176947, -2359296},
+    {-9929, -200540, -2359296},
+    {-12052, -224133, -2359296},
+    {-14411, -247726, -2359296},
+    {-17007, -271319, -2359296},
+    {-19838, -294912, -2359296},
+    {-22905, -318505, -2359296},
+    {-26208, -342098, -2359296},
+    {-29747, -365691, -2359296},
+    {-33522, -389284, -2359296},
+    {-37532, -412877, -2359296},
+    {-41779, -436470, -2359296},
+    {-46262, -460063, -2359296},
+    {-50980, -483656, -2359296},
+    {-55935, -507249, -2359296},
+    {-61125, -530842, -2359296},
+    {-66552, -554435, -2359296},
+    {-72214, -578028, -2359296},
+    {-78112, -601620, -2359296},
+    {-84247, -625213, -2359296},
+    {-90617, -648806, -2359296},
+    {-97223, -672399, -2359296},
+    {-104065, -695992, -2359296},
+    {-111143, -719585, -2359296},
+    {-118456, -743178, -2359296},
+    {-126006, -766771, -2359296},
+    {-133792, -790364, -2359296},
+    {-141813, -813957, -2359296},
+    {-150071, -837550, -2359296},
+    {-158561, -860488, -2293760},
+    {-167271, -881459, -2097152},
+    {-176180, -900465, -1900544},
+    {-185270, -917504, -1703936},
+    {-194521, -932577, -1507328},
+    {-203912, -945684, -1310720},
+    {-213425, -956826, -1114112},
+    {-223039, -966001, -917504},
+    {-232735, -973210, -720896},
+    {-242493, -978452, -524288},
+    {-252294, -981729, -327680},
+    {-262118, -983040, -131072},
+    {-271948, -983040, 0},
+    {-281779, -983040, 0},
+    {-291609, -983040, 0},
+    {-301439, -983040, 0},
+    {-311270, -983040, 0},
+    {-321100, -983040, 0},
+    {-330931, -983040, 0},
+    {-340761, -983040, 0},
+    {-350591, -983040, 0},
+    {-360422, -983040, 0},
+    {-370252, -983040, 0},
+    {-380083, -983040, 0},
+    {-389913, -983040, 0},
+    {-399743, -983040, 0},
+    {-409574, -983040, 0},
+    {-419404, -983040, 0},
+    {-429235, -983040, 0},
+    {-439065, -983040, 0},
+    {-448895, -983040, 0},
+    {-458726, -983040, 0},
+    {-468556, -983040, 0},
+    {-478387, -983040, 0},
+    {-488217, -983040, 0},
+    {-498047, -983040, 0},
+    {-507878, -983040, 0},
+    {-517708, -983040, 0},
+    {-527539, -983040, 0},
+    {-537369, -983040, 0},
+    {-547199, -983040, 0},
+    {-557030, -983040, 0},
+    {-566860, -983040, 0},
+    {-576691, -983040, 0},
+    {-586521, -983040, 0},
+    {-596351, -983040, 0},
+    {-606182, -983040, 0},
+    {-616012, -983040, 0},
+    {-625843, -983040, 0},
+    {-635673, -983040, 0},
+    {-645503, -983040, 0},
+    {-655334, -983040, 0},
+    {-665164, -983040, 0},
+    {-674995, -983040, 0},
+    {-684825, -983040, 0},
+    {-694655, -983040, 0},
+    {-704486, -983040, 0},
+    {-714316, -983040, 0},
+    {-724147, -983040, 0},
+    {-733977, -983040, 0},
+    {-743807, -983040, 0},
+    {-753638, -983040, 0},
+    {-763468, -983040, 0},
+    {-773299, -983040, 0},
+    {-783129, -983040, 0},
+    {-792959, -983040, 0},
+    {-802790, -983040, 0},
+    {-812620, -983040, 0},
+    {-822451, -983040, 0},
+    {-832281, -983040, 0},
+    {-842111, -983040, 0},
+    {-851942, -983040, 0},
+    {-861772, -983040, 0},
+    {-871603, -983040, 0},
+    {-881433, -983040, 0},
+    {-891263, -983040, 0},
+    {-901094, -983040, 0},
+    {-910924, -983040, 0},
+    {-920755, -983040, 0},
+    {-930585, -983040, 0},
+    {-940415, -983040, 0},
+    {-950246, -983040, 0},
+    {-960076, -983040, 0},
+    {-969907, -983040, 0},
+    {-979737, -983040, 0},
+    {-989567, -983040, 0},
+    {-999398, -983040, 0},
+    {-1009228, -983040, 0},
+    {-1019059, -983040, 0},
+    {-1028889, -983040, 0},
+    {-1038719, -983040, 0},
+    {-1048550, -983040, 0},
+    {-1058380, -983040, 0},
+    {-1068211, -983040, 0},
+    {-1078041, -983040, 0},
+    {-1087871, -983040, 0},
+    {-1097702, -983040, 0},
+    {-1107532, -983040, 0},
+    {-1117363, -983040, 0},
+    {-1127193, -983040, 0},
+    {-1137023, -983040, 0},
+    {-1146854, -983040, 0},
+    {-1156684, -983040, 0},
+    {-1166515, -983040, 0},
+    {-1176345, -983040, 0},
+    {-1186175, -983040, 0},
+    {-1196006, -983040, 0},
+    {-1205836, -983040, 0},
+    {-1215667, -983040, 0},
+    {-1225497, -983040, 0},
+    {-1235327, -983040, 0},
+    {-1245158, -983040, 0},
+    {-1254988, -983040, 0},
+    {-1264819, -983040, 0},
+    {-1274649, -983040, 0},
+    {-1284479, -983040, 0},
+    {-1294310, -983040, 0},
+    {-1304140, -983040, 0},
+    {-1313971, -983040, 0},
+    {-1323791, -981074, 196608},
+    {-1333582, -977142, 393216},
+    {-1343324, -971244, 589824},
+    {-1352997, -963379, 786432},
+    {-1362582, -953549, 983040},
+    {-1372058, -941752, 1179648},
+    {-1381407, -927990, 1376256},
+    {-1390608, -912261, 1572864},
+    {-1399643, -894566, 1769472},
+    {-1408490, -874906, 1966080},
+    {-1417131, -853279, 2162688},
+    {-1425546, -829686, 2359296},
+    {-1433725, -806093, 2359296},
+    {-1441667, -782500, 2359296},
+    {-1449375, -758907, 2359296},
+    {-1456846, -735314, 2359296},
+    {-1464081, -711721, 2359296},
+    {-1471080, -688128, 2359296},
+    {-1477843, -664535, 2359296},
+    {-1484371, -640942, 2359296},
+    {-1490662, -617349, 2359296},
+    {-1496718, -593756, 2359296},
+    {-1502537, -570163, 2359296},
+    {-1508121, -546570, 2359296},
+    {-1513469, -522977, 2359296},
+    {-1518581, -499384, 2359296},
+    {-1523456, -475791, 2359296},
+    {-1528096, -452198, 2359296},
+    {-1532500, -428605, 2359296},
+    {-1536668, -405012, 2359296},
+    {-1540601, -381420, 2359296},
+    {-1544297, -357827, 2359296},
+    {-1547757, -334234, 2359296},
+    {-1550982, -310641, 2359296},
+    {-1553970, -287048, 2359296},
+    {-1556722, -263455, 2359296},
+    {-1559239, -239862, 2359296},
+    {-1561520, -216269, 2359296},
+    {-1563564, -192676, 2359296},
+    {-1565373, -169083, 2359296},
+    {-1566946, -145490, 2359296},
+    {-1568286, -122552, 2293760},
+    {-1569407, -101581, 2097152},
+    {-1570328, -82575, 1900544},
+    {-1571068, -65536, 1703936},
+    {-1571648, -50463, 1507328},
+    {-1572087, -37356, 1310720},
+    {-1572405, -26214, 1114112},
+    {-1572622, -17039, 917504},
+    {-1572756, -9830, 720896},
+    {-1572828, -4588, 524288},
+    {-1572857, -1311, 327680},
+    {-1572864, 0, 131072},
+    {-1572864, 0, 0},
+};
+
+// rowPath leg 2: turn from (16.0, 0.0) at 0.0 degrees, 1.60s
+static const ProfilePoint rowPathLeg2[160] =
+{
+    {-66, -13107, -1310720},
+    {-328, -39322, -2621440},
+    {-918, -78643, -3932160},
+    {-1966, -131072, -5242880},
+    {-3604, -196608, -6553600},
+    {-5964, -275251, -7864320},
+    {-9175, -367002, -9175040},
+    {-13369, -471859, -10485760},
+    {-18678, -589824, -11796480},
+    {-25231, -720896, -13107200},
+    {-33161, -865075, -14417920},
+    {-42598, -1022362, -15728640},
+    {-53674, -1192755, -17039360},
+    {-66519, -1376256, -18350080},
+    {-81265, -1572864, -19660800},
+    {-97976, -1769472, -19660800},
+    {-116654, -1966080, -19660800},
+    {-137298, -2162688, -19660800},
+    {-159908, -2359296, -19660800},
+    {-184484, -2555904, -19660800},
+    {-211026, -2752512, -19660800},
+    {-239534, -2949120, -19660800},
+    {-270008, -3145728, -19660800},
+    {-302449, -3342336, -19660800},
+    {-336855, -3538944, -19660800},
+    {-373228, -3735552, -19660800},
+    {-411566, -3932160, -19660800},
+    {-451871, -4128768, -19660800},
+    {-494141, -4325376, -19660800},
+    {-538378, -4521984, -19660800},
+    {-584581, -4718592, -19660800},
+    {-632750, -4915200, -19660800},
+    {-682885, -5111808, -19660800},
+    {-734986, -5308416, -19660800},
+    {-789053, -5505024, -19660800},
+    {-845087, -5701632, -19660800},
+    {-903086, -5898240, -19660800},
+    {-963052, -6094848, -19660800},
+    {-1024983, -6291456, -19660800},
+    {-1088881, -6488064, -19660800},
+    {-1154679, -6671565, -18350080},
+    {-1222246, -6841958, -17039360},
+    {-1291452, -6999245, -15728640},
+    {-1362166, -7143424, -14417920},
+    {-1434255, -7274496, -13107200},
+    {-1507590, -7392461, -11796480},
+    {-1582039, -7497318, -10485760},
+    {-1657471, -7589069, -9175040},
+    {-1733755, -7667712, -7864320},
+    {-1810760, -7733248, -6553600},
+    {-1888354, -7785677, -5242880},
+    {-1966408, -7824998, -3932160},
+    {-2044789, -7851213, -2621440},
+    {-2123366, -7864320, -1310720},
+    {-2202010, -7864320, 0},
+    {-2280653, -7864320, 0},
+    {-2359296, -7864320, 0},
+    {-2437939, -7864320, 0},
+    {-2516582, -7864320, 0},
+    {-2595226, -7864320, 0},
+    {-2673869, -7864320, 0},
+    {-2752512, -7864320, 0},
+    {-2831155, -7864320, 0},
+    {-2909798, -7864320, 0},
+    {-2988442, -7864320, 0},
+    {-3067085, -7864320, 0},
+    {-3145728, -7864320, 0},
+    {-3224371, -7864320, 0},
+    {-3303014, -7864320, 0},
+    {-3381658, -7864320, 0},
+    {-3460301, -7864320, 0},
+    {-3538944, -7864320, 0},
+    {-3617587, -7864320, 0},
+    {-3696230, -7864320, 0},
+    {-3774874, -7864320, 0},
+    {-3853517, -7864320, 0},
+    {-3932160, -7864320, 0},
+    {-4010803, -7864320, 0},
+    {-4089446, -7864320, 0},
+    {-4168090, -7864320, 0},
+    {-4246733, -7864320, 0},
+    {-4325376, -7864320, 0},
+    {-4404019, -7864320, 0},
+    {-4482662, -7864320, 0},
+    {-4561306, -7864320, 0},
+    {-4639949, -7864320, 0},
+    {-4718592, -7864320, 0},
+    {-4797235, -7864320, 0},
+    {-4875878, -7864320, 0},
+    {-4954522, -7864320, 0},
+    {-5033165, -7864320, 0},
+    {-5111808, -7864320, 0},
+    {-5190451, -7864320, 0},
+    {-5269094, -7864320, 0},
+    {-5347738, -7864320, 0},
+    {-5426381, -7864320, 0},
+    {-5505024, -7864320, 0},
+    {-5583667, -7864320, 0},
+    {-5662310, -7864320, 0},
+    {-5740954, -7864320, 0},
+    {-5819597, -7864320, 0},
+    {-5898240, -7864320, 0},
+    {-5976883, -7864320, 0},
+    {-6055526, -7864320, 0},
+    {-6134144, -7859270, 504979},
+    {-6212646, -7841113, 1815699},
+    {-6290901, -7809849, 3126419},
+    {-6368778, -7765478, 4437139},
+    {-6446145, -7707999, 5747859},
+    {-6522872, -7637413, 7058579},
+    {-6598828, -7553720, 8369299},
+    {-6673881, -7456920, 9680019},
+    {-6747901, -7347013, 10990739},
+    {-6820756, -7223998, 12301459},
+    {-6892315, -7087876, 13612179},
+    {-6962448, -6938647, 14922899},
+    {-7031023, -6776311, 16233619},
+    {-7097908, -6600868, 17544339},
+    {-7162974, -6412317, 18855059},
+    {-7226114, -6215709, 19660800},
+    {-7287289, -6019101, 19660800},
+    {-7346496, -5822493, 19660800},
+    {-7403738, -5625885, 19660800},
+    {-7459014, -5429277, 19660800},
+    {-7512324, -5232669, 19660800},
+    {-7563668, -5036061, 19660800},
+    {-7613045, -4839453, 19660800},
+    {-7660457, -4642845, 19660800},
+    {-7705902, -4446237, 19660800},
+    {-7749381, -4249629, 19660800},
+    {-7790895, -4053021, 19660800},
+    {-7830442, -3856413, 19660800},
+    {-7868023, -3659805, 19660800},
+    {-7903638, -3463197, 19660800},
+    {-7937287, -3266589, 19660800},
+    {-7968970, -3069981, 19660800},
+    {-7998686, -2873373, 19660800},
+    {-8026437, -2676765, 19660800},
+    {-8052222, -2480157, 19660800},
+    {-8076040, -2283549, 19660800},
+    {-8097893, -2086941, 19660800},
+    {-8117779, -1890333, 19660800},
+    {-8135699, -1693725, 19660800},
+    {-8151654, -1497117, 19660800},
+    {-8165667, -1305559, 19155821},
+    {-8177830, -1127108, 17845101},
+    {-8188275, -961764, 16534381},
+    {-8197131, -809527, 15223661},
+    {-8204531, -670398, 13912941},
+    {-8210605, -544376, 12602221},
+    {-8215484, -431461, 11291501},
+    {-8219299, -331653, 9980781},
+    {-8222182, -244952, 8670061},
+    {-8224264, -171359, 7359341},
+    {-8225675, -110873, 6048621},
+    {-8226547, -63494, 4737901},
+    {-8227011, -29222, 3427181},
+    {-8227197, -8057, 2116461},
+    {-8227237, 0, 805741},
+    {-8227237, 0, 0},
+};
+
+// rowPath leg 3: drive from (16.0, 0.0) at -125.5 degrees, 1.69s
+static const ProfilePoint rowPathLeg3[169] =
+{
+    {10, 1966, 196608},
+    {49, 5898, 393216},
+    {138, 11796, 589824},
+    {295, 19661, 786432},
+    {541, 29491, 983040},
+    {895, 41288, 1179648},
+    {1376, 55050, 1376256},
+    {2005, 70779, 1572864},
+    {2802, 88474, 1769472},
+    {3785, 108134, 1966080},
+    {4974, 129761, 2162688},
+    {6390, 153354, 2359296},
+    {8041, 176947, 2359296},
+    {9929, 200540, 2359296},
+    {12052, 224133, 2359296},
+    {14412, 247726, 2359296},
+    {17007, 271319, 2359296},
+    {19838, 294912, 2359296},
+    {22905, 318505, 2359296},
+    {26208, 342098, 2359296},
+    {29747, 365691, 2359296},
+    {33522, 389284, 2359296},
+    {37533, 412877, 2359296},
+    {41780, 436470, 2359296},
+    {46263, 460063, 2359296},
+    {50982, 483656, 2359296},
+    {55936, 507249, 2359296},
+    {61127, 530842, 2359296},
+    {66553, 554435, 2359296},
+    {72216, 578028, 2359296},
+    {78114, 601620, 2359296},
+    {84248, 625213, 2359296},
+    {90619, 648806, 2359296},
+    {97225, 672399, 2359296},
+    {104067, 695992, 2359296},
+    {111145, 719585, 2359296},
+    {118459, 743178, 2359296},
+    {126009, 766771, 2359296},
+    {133795, 790364, 2359296},
+    {141816, 813957, 2359296},
+    {150074, 837550, 2359296},
+    {158564, 860488, 2293760},
+    {167274, 881459, 2097152},
+    {176184, 900465, 1900544},
+    {185274, 917504, 1703936},
+    {194525, 932577, 1507328},
+    {203916, 945684, 1310720},
+    {213429, 956826, 1114112},
+    {223043, 966001, 917504},
+    {232740, 973210, 720896},
+    {242498, 978452, 524288},
+    {252299, 981729, 327680},
+    {262123, 983040, 131072},
+    {271954, 983040, 0},
+    {281785, 983040, 0},
+    {291615, 983040, 0},
+    {301446, 983040, 0},
+    {311276, 983040, 0},
+    {321107, 983040, 0},
+    {330938, 983040, 0},
+    {340768, 983040, 0},
+    {350599, 983040, 0},
+    {360429, 983040, 0},
+    {370260, 983040, 0},
+    {380091, 983040, 0},
+    {389921, 983040, 0},
+    {399752, 983040, 0},
+    {409582, 983040, 0},
+    {419413, 983040, 0},
+    {429244, 983040, 0},
+    {439074, 983040, 0},
+    {448905, 983040, 0},
+    {458735, 983040, 0},
+    {468566, 983040, 0},
+    {478397, 983040, 0},
+    {488227, 983040, 0},
+    {498058, 983040, 0},
+    {507888, 983040, 0},
+    {517719, 983040, 0},
+    {527550, 983040, 0},
+    {537380, 983040, 0},
+    {547211, 983040, 0},
+    {557042, 983040, 0},
+    {566872, 983040, 0},
+    {576703, 983040, 0},
+    {586533, 983040, 0},
+    {596364, 983040, 0},
+    {606195, 983040, 0},
+    {616025, 983040, 0},
+    {625856, 983040, 0},
+    {635686, 983040, 0},
+    {645517, 983040, 0},
+    {655348, 983040, 0},
+    {665178, 983040, 0},
+    {675009, 983040, 0},
+    {684839, 983040, 0},
+    {694670, 983040, 0},
+    {704501, 983040, 0},
+    {714331, 983040, 0},
+    {724162, 983040, 0},
+    {733992, 983040, 0},
+    {743823, 983040, 0},
+    {753654, 983040, 0},
+    {763484, 983040, 0},
+    {773315, 983040, 0},
+    {783145, 983040, 0},
+    {792976, 983040, 0},
+    {802807, 983040, 0},
+    {812637, 983040, 0},
+    {822468, 983040, 0},
+    {832299, 983040, 0},
+    {842129, 983040, 0},
+    {851960, 983040, 0},
+    {861790, 983040, 0},
+    {871618, 982446, -59440},
+    {881430, 979885, -256048},
+    {891206, 975359, -452656},
+    {900928, 968866, -649264},
+    {910574, 960407, -845872},
+    {920126, 949982, -1042480},
+    {929564, 937591, -1239088},
+    {938869, 923235, -1435696},
+    {948020, 906911, -1632304},
+    {956997, 888622, -1828912},
+    {965783, 868367, -2025520},
+    {974355, 846146, -2222128},
+    {982699, 822553, -2359296},
+    {990807, 798960, -2359296},
+    {998679, 775367, -2359296},
+    {1006314, 751774, -2359296},
+    {1013714, 728181, -2359296},
+    {1020878, 704588, -2359296},
+    {1027806, 680995, -2359296},
+    {1034499, 657402, -2359296},
+    {1040955, 633809, -2359296},
+    {1047175, 610216, -2359296},
+    {1053159, 586623, -2359296},
+    {1058908, 563030, -2359296},
+    {1064420, 539437, -2359296},
+    {1069697, 515844, -2359296},
+    {1074737, 492251, -2359296},
+    {1079542, 468659, -2359296},
+    {1084111, 445066, -2359296},
+    {1088443, 421473, -2359296},
+    {1092540, 397880, -2359296},
+    {1096401, 374287, -2359296},
+    {1100026, 350694, -2359296},
+    {1103415, 327101, -2359296},
+    {1106568, 303508, -2359296},
+    {1109486, 279915, -2359296},
+    {1112167, 256322, -2359296},
+    {1114612, 232729, -2359296},
+    {1116821, 209136, -2359296},
+    {1118795, 185543, -2359296},
+    {1120532, 161950, -2359296},
+    {1122034, 138357, -2359296},
+    {1123306, 116014, -2234320},
+    {1124364, 95637, -2037712},
+    {1125228, 77226, -1841104},
+    {1125918, 60781, -1644496},
+    {1126454, 46302, -1447888},
+    {1126854, 33789, -1251280},
+    {1127140, 23242, -1054672},
+    {1127329, 14662, -858064},
+    {1127443, 8047, -661456},
+    {1127500, 3399, -464848},
+    {1127520, 716, -268240},
+    {1127524, 0, -71632},
+    {1127524, 0, 0},
+};
+
+static const PathLeg rowPathLegs[4] =
+{
+    {PATH_LEG_DRIVE, 0, 0, 0, rowPathLeg0, 321},
+    {PATH_LEG_DRIVE, 2621440, 0, 0, rowPathLeg1, 214},
+    {PATH_LEG_TURN, 1048576, 0, 0, rowPathLeg2, 160},
+    {PATH_LEG_DRIVE, 1048576, 0, -8227237, rowPathLeg3, 169},
+};
+
+const Path rowPath =
+{
+    "rowPath",
+    {0, 0, 0},
+    rowPathLegs,
+    4
+};
+
+const Path *const autonPaths[] =
+{
+    &rowPath,
+};
+
+const unsigned int autonPathCount = 1;
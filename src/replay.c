@@ -0,0 +1,427 @@
+/** @file replay.c
+ * @brief Recording a driver run to flash and replaying it
+ *
+ * The ring buffer has a single producer (the control task calling replayRecord()) and a single
+ * consumer (the writer task), like telemetry.c. The writer only ever runs while the control task
+ * is blocked between ticks, so once it clears producing the tick count it reads for the end frame
+ * can't change under it.
+ */
+
+#include "main.h"
+#include "memory.h"
+#include "replay.h"
+#include "stack.h"
+
+#define REPLAY_BUFFER_MASK (REPLAY_BUFFER_SIZE - 1)
+
+// Longest frame: the gap, the mask, 4 axes and the buttons
+#define REPLAY_FRAME_SIZE 8
+
+// Longest gap a frame can hold
+#define REPLAY_MAX_GAP 255
+
+// Bytes read from flash at a time during playback
+#define REPLAY_READ_SIZE 32
+
+// Allocated from the arena by replayInit()
+static uint8_t *buffer = NULL;
+// Next byte to write (only changed by the producer) and next to send (only by the consumer)
+static volatile unsigned int head = 0;
+static volatile unsigned int tail = 0;
+
+static volatile ReplayState state = REPLAY_IDLE;
+// Whether replayRecord() is adding ticks. Cleared by either side to end the recording.
+static volatile bool producing = false;
+// Whether the writer fell behind and a frame didn't fit in the buffer
+static volatile bool overflowed = false;
+// Bytes queued so far, including the header
+static volatile size_t queued = 0;
+// Bytes written to flash so far
+static volatile size_t written = 0;
+
+// Producer state: the last snapshot recorded, the current tick and the tick of the last frame
+static JoystickState recorded;
+static volatile uint32_t recordTick = 0;
+static volatile uint32_t lastFrameTick = 0;
+
+static TaskHandle writerTask = NULL;
+
+// Playback state, only used by the control task
+static PROS_FILE *playFile = NULL;
+static uint8_t readBuffer[REPLAY_READ_SIZE];
+static size_t readPosition = 0;
+static size_t readLength = 0;
+static uint32_t playTick = 0;
+static uint32_t nextFrameTick = 0;
+static int8_t playAxes[4];
+static uint16_t playButtons = 0;
+
+/**
+ * Queues bytes for the writer, or ends the recording if they won't fit
+ *
+ * @return true if the bytes were queued
+ */
+static bool push(const uint8_t *bytes, unsigned int count)
+{
+    // Always leave room in the file for the end frame
+    if(REPLAY_BUFFER_SIZE - (head - tail) < count || queued + count + 2 > REPLAY_MAX_SIZE)
+    {
+        overflowed = queued + count + 2 <= REPLAY_MAX_SIZE;
+        producing = false;
+        return false;
+    }
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        buffer[(head + i) & REPLAY_BUFFER_MASK] = bytes[i];
+    }
+    queued += count;
+
+    // Publish the bytes only once they have been completely written
+    __sync_synchronize();
+    head += count;
+    return true;
+}
+
+/**
+ * Writes everything queued to the file
+ *
+ * @return false if the flash refused some of it
+ */
+static bool drain(PROS_FILE *file)
+{
+    while(tail != head)
+    {
+        // Write up to the end of the buffer, then wrap around next time
+        unsigned int start = tail & REPLAY_BUFFER_MASK;
+        unsigned int count = head - tail;
+        if(count > REPLAY_BUFFER_SIZE - start)
+        {
+            count = REPLAY_BUFFER_SIZE - start;
+        }
+        size_t done = fwrite(&buffer[start], 1, count, file);
+        written += done;
+
+        // Make sure the bytes have been read before the producer is allowed to reuse them
+        __sync_synchronize();
+        tail += count;
+        if(done != count)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Writes recordings to flash as they are made. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void replayWriter(void *ignore)
+{
+    PROS_FILE *file = NULL;
+    bool failed = false;
+    while(true)
+    {
+        if(state == REPLAY_RECORDING)
+        {
+            if(file == NULL)
+            {
+                file = fopen(REPLAY_FILE, "w");
+                failed = file == NULL;
+            }
+            if(!failed)
+            {
+                failed = !drain(file);
+            }
+
+            // The kernel stops the control task when the robot is disabled
+            if(failed || !producing || !isEnabled())
+            {
+                producing = false;
+                if(!failed)
+                {
+                    failed = !drain(file);
+                }
+                uint8_t end[2] = {(uint8_t)(recordTick - lastFrameTick), REPLAY_END};
+                if(!failed)
+                {
+                    size_t done = fwrite(end, 1, sizeof(end), file);
+                    written += done;
+                    failed = done != sizeof(end);
+                }
+                if(file != NULL)
+                {
+                    fclose(file);
+                    file = NULL;
+                }
+                state = failed || overflowed ? REPLAY_FAILED : REPLAY_SAVED;
+                tail = head;
+            }
+        }
+
+        taskDelay(REPLAY_DRAIN_PERIOD);
+    }
+}
+
+void replayInit()
+{
+    if(writerTask == NULL)
+    {
+        buffer = memoryAlloc(REPLAY_BUFFER_SIZE, "replay");
+        if(buffer == NULL)
+        {
+            return;
+        }
+
+        writerTask = stackTaskCreate("REPLAY", replayWriter, REPLAY_STACK_SIZE, NULL,
+            REPLAY_TASK_PRIORITY);
+    }
+}
+
+void replayArm(bool armed)
+{
+    if(state != REPLAY_RECORDING)
+    {
+        state = armed ? REPLAY_ARMED : REPLAY_IDLE;
+    }
+}
+
+ReplayState replayState()
+{
+    return state;
+}
+
+size_t replaySize()
+{
+    return state == REPLAY_RECORDING ? queued : written;
+}
+
+void replayRecordStart(unsigned int period)
+{
+    if(state != REPLAY_ARMED || writerTask == NULL)
+    {
+        return;
+    }
+
+    head = tail = 0;
+    queued = written = 0;
+    overflowed = false;
+    recorded = (JoystickState) {0};
+    recordTick = lastFrameTick = 0;
+
+    const uint8_t header[4] = {'R', 'P', REPLAY_VERSION, (uint8_t)period};
+    producing = true;
+    push(header, sizeof(header));
+
+    // The writer opens the file once it sees the state change
+    __sync_synchronize();
+    state = REPLAY_RECORDING;
+}
+
+void replayRecord(const JoystickState *snapshot)
+{
+    if(!producing)
+    {
+        return;
+    }
+
+    uint32_t tick = recordTick;
+    uint8_t frame[REPLAY_FRAME_SIZE];
+    unsigned int size = 2;
+    uint8_t mask = 0;
+    for(unsigned int axis = 0; axis < 4; axis++)
+    {
+        if(tick == 0 || snapshot->axes[axis] != recorded.axes[axis])
+        {
+            mask |= 1 << axis;
+            frame[size++] = (uint8_t)snapshot->axes[axis];
+        }
+    }
+    if(tick == 0 || snapshot->buttons != recorded.buttons)
+    {
+        mask |= REPLAY_BUTTONS;
+        frame[size++] = (uint8_t)snapshot->buttons;
+        frame[size++] = (uint8_t)(snapshot->buttons >> 8);
+    }
+
+    // Unchanged ticks cost nothing until the gap is too long for the next frame to hold
+    if(mask != 0 || tick - lastFrameTick >= REPLAY_MAX_GAP)
+    {
+        frame[0] = (uint8_t)(tick - lastFrameTick);
+        frame[1] = mask;
+        if(!push(frame, size))
+        {
+            return;
+        }
+        lastFrameTick = tick;
+        recorded = *snapshot;
+    }
+    recordTick = tick + 1;
+}
+
+/**
+ * Reads the next byte of the recording being played
+ *
+ * @return true if there was one
+ */
+static bool readByte(uint8_t *byte)
+{
+    if(readPosition == readLength)
+    {
+        readLength = fread(readBuffer, 1, sizeof(readBuffer), playFile);
+        readPosition = 0;
+        if(readLength == 0)
+        {
+            return false;
+        }
+    }
+    *byte = readBuffer[readPosition++];
+    return true;
+}
+
+/**
+ * Ends playback and closes the file
+ */
+static void playEnd()
+{
+    if(playFile != NULL)
+    {
+        fclose(playFile);
+        playFile = NULL;
+    }
+}
+
+bool replayStart(unsigned int period)
+{
+    playEnd();
+    playFile = fopen(REPLAY_FILE, "r");
+    if(playFile == NULL)
+    {
+        return false;
+    }
+
+    readPosition = readLength = 0;
+    playTick = 0;
+    playButtons = 0;
+    for(unsigned int axis = 0; axis < 4; axis++)
+    {
+        playAxes[axis] = 0;
+    }
+
+    uint8_t header[5];
+    for(unsigned int i = 0; i < sizeof(header); i++)
+    {
+        if(!readByte(&header[i]))
+        {
+            playEnd();
+            return false;
+        }
+    }
+    if(header[0] != 'R' || header[1] != 'P' || header[2] != REPLAY_VERSION ||
+        header[3] != period)
+    {
+        playEnd();
+        return false;
+    }
+    // The gap of the first frame
+    nextFrameTick = header[4];
+    return true;
+}
+
+/**
+ * Applies the frame due now and reads the gap to the next one
+ *
+ * @return false at the end of the recording, or if the file is cut short
+ */
+static bool playFrame()
+{
+    uint8_t mask;
+    if(!readByte(&mask) || (mask & REPLAY_END))
+    {
+        return false;
+    }
+
+    for(unsigned int axis = 0; axis < 4; axis++)
+    {
+        uint8_t value;
+        if((mask & (1 << axis)) && !readByte(&value))
+        {
+            return false;
+        }
+        if(mask & (1 << axis))
+        {
+            playAxes[axis] = (int8_t)value;
+        }
+    }
+    if(mask & REPLAY_BUTTONS)
+    {
+        uint8_t low;
+        uint8_t high;
+        if(!readByte(&low) || !readByte(&high))
+        {
+            return false;
+        }
+        playButtons = (uint16_t)(low | (high << 8));
+    }
+
+    // Only the first frame can have a gap of 0, so anything else is a damaged file
+    uint8_t gap;
+    if(!readByte(&gap) || gap == 0)
+    {
+        return false;
+    }
+    nextFrameTick += gap;
+    return true;
+}
+
+bool replayNext(JoystickState *snapshot)
+{
+    while(playFile != NULL && playTick == nextFrameTick)
+    {
+        if(!playFrame())
+        {
+            playEnd();
+        }
+    }
+
+    if(playFile == NULL)
+    {
+        playButtons = 0;
+        for(unsigned int axis = 0; axis < 4; axis++)
+        {
+            playAxes[axis] = 0;
+        }
+    }
+    playTick++;
+
+    for(unsigned int axis = 0; axis < 4; axis++)
+    {
+        snapshot->axes[axis] = playAxes[axis];
+    }
+    joystickSetButtons(snapshot, playButtons);
+    return playFile != NULL;
+}
+
+void replayPrint(PROS_FILE *stream)
+{
+    PROS_FILE *file = fopen(REPLAY_FILE, "r");
+    if(file == NULL)
+    {
+        fprintf(stream, "No recording\r\n");
+        return;
+    }
+
+    uint8_t bytes[REPLAY_READ_SIZE];
+    size_t count;
+    while((count = fread(bytes, 1, sizeof(bytes), file)) > 0)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            fprintf(stream, "%02x", bytes[i]);
+        }
+        fprintf(stream, "\r\n");
+    }
+    fclose(file);
+}
@@ -0,0 +1,129 @@
+/** @file scheduler.c
+ * @brief Fixed-rate scheduler for periodic control jobs
+ *
+ * See scheduler.h for how jobs are run.
+ */
+
+#include "main.h"
+#include "scheduler.h"
+#include "timing.h"
+
+static Job jobs[SCHEDULER_MAX_JOBS];
+static unsigned int jobCount = 0;
+static unsigned long tickOverruns = 0;
+
+void schedulerReset()
+{
+    jobCount = 0;
+    tickOverruns = 0;
+}
+
+bool schedulerAdd(const char *name, JobCode code, unsigned long period, unsigned int priority)
+{
+    if(jobCount >= SCHEDULER_MAX_JOBS || code == NULL || period < SCHEDULER_TICK_MS ||
+        period % SCHEDULER_TICK_MS != 0)
+    {
+        return false;
+    }
+
+    // Keep the table sorted by priority so a tick is a single pass over it.
+    // Jobs with equal priority run in the order they were added.
+    unsigned int index = jobCount;
+    while(index > 0 && jobs[index - 1].priority < priority)
+    {
+        jobs[index] = jobs[index - 1];
+        index--;
+    }
+
+    jobs[index].name = name;
+    jobs[index].code = code;
+    jobs[index].periodTicks = period / SCHEDULER_TICK_MS;
+    jobs[index].priority = priority;
+    jobs[index].overruns = 0;
+    jobs[index].timing = timingRegister(name);
+    jobCount++;
+
+    return true;
+}
+
+void schedulerRun()
+{
+    const int tickTiming = timingRegister("tick");
+    const int jitterTiming = timingRegister("jitter");
+
+    unsigned long tick = 0;
+    unsigned long wakeTime = millis();
+    uint32_t lastTickStart = timingNow();
+
+    while(1)
+    {
+        uint32_t tickStart = timingNow();
+        if(tick != 0)
+        {
+            int lateness = timingToMicros(tickStart - lastTickStart) - SCHEDULER_TICK_MS * 1000;
+            timingRecord(jitterTiming, lateness < 0 ? -lateness : lateness);
+        }
+        lastTickStart = tickStart;
+
+        for(unsigned int i = 0; i < jobCount; i++)
+        {
+            Job *job = &jobs[i];
+            if(tick % job->periodTicks != 0)
+            {
+                continue;
+            }
+
+            timingBegin(job->timing);
+            job->code();
+            if(timingEnd(job->timing) > job->periodTicks * SCHEDULER_TICK_MS * 1000)
+            {
+                job->overruns++;
+            }
+        }
+
+        timingRecord(tickTiming, timingToMicros(timingNow() - tickStart));
+        tick++;
+
+        // If this tick ran past the start of the next one, count it and skip the ticks that
+        // were missed instead of running them back to back to catch up
+        unsigned long now = millis();
+        if(now - wakeTime >= SCHEDULER_TICK_MS)
+        {
+            unsigned long missed = (now - wakeTime) / SCHEDULER_TICK_MS;
+            tickOverruns++;
+            tick += missed;
+            wakeTime += missed * SCHEDULER_TICK_MS;
+        }
+
+        taskDelayUntil(&wakeTime, SCHEDULER_TICK_MS);
+    }
+}
+
+unsigned long schedulerTickOverruns()
+{
+    return tickOverruns;
+}
+
+unsigned int schedulerJobCount()
+{
+    return jobCount;
+}
+
+const Job *schedulerGetJob(unsigned int index)
+{
+    if(index >= jobCount)
+    {
+        return NULL;
+    }
+    return &jobs[index];
+}
+
+void schedulerPrintStats(PROS_FILE *stream)
+{
+    fprintf(stream, "tick overruns: %lu\r\n", tickOverruns);
+    for(unsigned int i = 0; i < jobCount; i++)
+    {
+        fprintf(stream, "%-10s %4ums overruns: %lu\r\n", jobs[i].name,
+            jobs[i].periodTicks * SCHEDULER_TICK_MS, jobs[i].overruns);
+    }
+}
@@ -0,0 +1,210 @@
+/** @file sensors.c
+ * @brief Filtered analog sensor service
+ */
+
+#include "main.h"
+#include "motor.h"
+#include "sensors.h"
+#include "stack.h"
+
+// Conversion from analogReadCalibratedHR() (the value times 16) to Q16
+#define HR_TO_Q16 4096
+
+// Readings per second, for turning the change per reading into a velocity
+#define READINGS_PER_SECOND (1000 / (SENSOR_SAMPLE_PERIOD * SENSOR_DECIMATION))
+
+/**
+ * Filter state and published reading of one channel
+ */
+typedef struct
+{
+    volatile bool enabled;
+    // Last three samples for the median, and how many have been taken so far
+    int samples[3];
+    unsigned int sampleCount;
+    // Sum of the medians since the last reading
+    int32_t sum;
+    unsigned int summed;
+    // Filter outputs, only touched by the sensor task
+    q16_t value;
+    q16_t velocity;
+    uint32_t count;
+
+    // Published reading, guarded by the sequence count: it is odd while being written
+    volatile uint32_t sequence;
+    volatile SensorReading published;
+} SensorChannel;
+
+static SensorChannel channels[SENSOR_CHANNELS];
+
+static TaskHandle sensorTask = NULL;
+
+// Smoothed battery voltage in mV, only written by the sensor task
+static volatile q16_t battery = 0;
+
+/**
+ * @return The median of three values
+ */
+static int median3(int a, int b, int c)
+{
+    if(a > b)
+    {
+        int swap = a;
+        a = b;
+        b = swap;
+    }
+    // Now a <= b, so the median is b unless c is outside of them
+    if(c < a)
+    {
+        return a;
+    }
+    return c < b ? c : b;
+}
+
+/**
+ * Publishes a channel's filter outputs for readers
+ */
+static void publish(SensorChannel *channel)
+{
+    channel->sequence++;
+    __sync_synchronize();
+    channel->published.value = channel->value;
+    channel->published.velocity = channel->velocity;
+    channel->published.count = channel->count;
+    __sync_synchronize();
+    channel->sequence++;
+}
+
+/**
+ * Takes a sample of a channel and makes a new reading every SENSOR_DECIMATION samples
+ */
+static void sample(SensorChannel *channel, unsigned char port)
+{
+    int raw = analogReadCalibratedHR(port);
+
+    channel->samples[0] = channel->samples[1];
+    channel->samples[1] = channel->samples[2];
+    channel->samples[2] = raw;
+    if(channel->sampleCount < 3)
+    {
+        // Fill the window with the first sample so the median starts out right
+        channel->sampleCount++;
+        if(channel->sampleCount == 1)
+        {
+            channel->samples[0] = raw;
+            channel->samples[1] = raw;
+        }
+    }
+
+    channel->sum += median3(channel->samples[0], channel->samples[1], channel->samples[2]);
+    channel->summed++;
+    if(channel->summed < SENSOR_DECIMATION)
+    {
+        return;
+    }
+
+    q16_t value = channel->sum * HR_TO_Q16 / SENSOR_DECIMATION;
+    channel->sum = 0;
+    channel->summed = 0;
+
+    if(channel->count > 0)
+    {
+        q16_t velocity = q16Saturate((int64_t)(value - channel->value) * READINGS_PER_SECOND);
+        channel->velocity += q16Mul(velocity - channel->velocity, SENSOR_VELOCITY_WEIGHT);
+    }
+    channel->value = value;
+    channel->count++;
+
+    publish(channel);
+}
+
+/**
+ * Reads the battery and updates the motor compensation
+ */
+static void sampleBattery()
+{
+    q16_t reading = q16FromInt((int)powerLevelMain());
+    // Start from the first reading instead of ramping up from 0
+    q16_t smoothed = battery == 0 ? reading :
+        battery + q16Mul(reading - battery, SENSOR_BATTERY_WEIGHT);
+    battery = smoothed;
+    motorOutSetBattery((unsigned int)q16ToInt(smoothed));
+}
+
+/**
+ * The sampling loop. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void sensorUpdate(void *ignore)
+{
+    unsigned long wakeTime = millis();
+    unsigned int sinceBattery = SENSOR_BATTERY_PERIOD;
+
+    while(1)
+    {
+        if(sinceBattery >= SENSOR_BATTERY_PERIOD)
+        {
+            sampleBattery();
+            sinceBattery = 0;
+        }
+        sinceBattery += SENSOR_SAMPLE_PERIOD;
+
+        for(unsigned char i = 0; i < SENSOR_CHANNELS; i++)
+        {
+            if(channels[i].enabled)
+            {
+                sample(&channels[i], i + 1);
+            }
+        }
+
+        taskDelayUntil(&wakeTime, SENSOR_SAMPLE_PERIOD);
+    }
+}
+
+void sensorsAddAnalog(unsigned char channel)
+{
+    if(channel < 1 || channel > SENSOR_CHANNELS)
+    {
+        return;
+    }
+
+    analogCalibrate(channel);
+    channels[channel - 1].enabled = true;
+}
+
+void sensorsInit()
+{
+    if(sensorTask == NULL)
+    {
+        sensorTask = stackTaskCreate("SENSOR", sensorUpdate, SENSOR_STACK_SIZE, NULL,
+            SENSOR_TASK_PRIORITY);
+    }
+}
+
+void sensorGet(unsigned char channel, SensorReading *reading)
+{
+    if(channel < 1 || channel > SENSOR_CHANNELS)
+    {
+        *reading = (SensorReading) {0};
+        return;
+    }
+
+    SensorChannel *source = &channels[channel - 1];
+    uint32_t sequence;
+    do
+    {
+        // Wait out a write in progress, then make sure no write started while copying
+        sequence = source->sequence;
+        __sync_synchronize();
+        reading->value = source->published.value;
+        reading->velocity = source->published.velocity;
+        reading->count = source->published.count;
+        __sync_synchronize();
+    } while((sequence & 1) || sequence != source->sequence);
+}
+
+unsigned int sensorBattery()
+{
+    return (unsigned int)q16ToInt(battery);
+}
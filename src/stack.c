@@ -0,0 +1,170 @@
+/** @file stack.c
+ * @brief Task stack high-watermark monitor
+ */
+
+#include "main.h"
+#include "memory.h"
+#include "stack.h"
+
+/**
+ * A monitored task
+ */
+typedef struct
+{
+    const char *name;
+    TaskHandle handle;
+    // Lowest word of the stack, or NULL if it couldn't be painted. Stacks grow down, so the
+    // paint is used up from the top and the free words are the ones left at the bottom.
+    const uint32_t *base;
+    unsigned int depth;
+    // Free words as of the last scan
+    volatile unsigned int freeWords;
+} StackTask;
+
+static StackTask tasks[STACK_MAX_TASKS];
+static unsigned int taskCount = 0;
+
+static TaskHandle monitorTask = NULL;
+
+/**
+ * Counts the words at the bottom of a stack that still have their paint
+ */
+static unsigned int countFree(const StackTask *task)
+{
+    unsigned int count = 0;
+    while(count < task->depth && task->base[count] == MEMORY_PAINT)
+    {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Works out a stack size with some headroom over the deepest use seen
+ */
+static unsigned int recommendedSize(const StackTask *task)
+{
+    unsigned int used = task->depth - task->freeWords;
+    unsigned int margin = used * STACK_MARGIN_PERCENT / 100;
+    if(margin < STACK_MARGIN_MIN)
+    {
+        margin = STACK_MARGIN_MIN;
+    }
+    return (used + margin + 15) & ~15u;
+}
+
+/**
+ * Scans every stack. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void stackMonitor(void *ignore)
+{
+    while(1)
+    {
+        for(unsigned int i = 0; i < taskCount; i++)
+        {
+            if(tasks[i].base != NULL)
+            {
+                tasks[i].freeWords = countFree(&tasks[i]);
+            }
+        }
+
+        taskDelay(STACK_MONITOR_PERIOD);
+    }
+}
+
+TaskHandle stackTaskCreate(const char *name, TaskCode taskCode, const unsigned int stackDepth,
+    void *parameters, const unsigned int priority)
+{
+    memoryWatchAllocation(stackDepth * sizeof(uint32_t));
+    TaskHandle handle = taskCreate(taskCode, stackDepth, parameters, priority);
+    const uint32_t *base = memoryWatchedBlock();
+
+    if(handle != NULL && taskCount < STACK_MAX_TASKS)
+    {
+        StackTask *task = &tasks[taskCount];
+        task->name = name;
+        task->handle = handle;
+        task->base = base;
+        task->depth = stackDepth;
+        task->freeWords = base != NULL ? countFree(task) : 0;
+        taskCount++;
+    }
+    return handle;
+}
+
+void stackMonitorInit()
+{
+    if(monitorTask == NULL)
+    {
+        monitorTask = stackTaskCreate("STACK_MONITOR", stackMonitor, STACK_MONITOR_STACK_SIZE,
+            NULL, STACK_MONITOR_PRIORITY);
+    }
+}
+
+unsigned int stackTaskCount()
+{
+    return taskCount;
+}
+
+unsigned int stackLowestFree()
+{
+    unsigned int lowest = UINT16_MAX;
+    for(unsigned int i = 0; i < taskCount; i++)
+    {
+        if(tasks[i].base != NULL && tasks[i].freeWords < lowest)
+        {
+            lowest = tasks[i].freeWords;
+        }
+    }
+    return lowest;
+}
+
+void stackPrint(PROS_FILE *stream)
+{
+    fprintf(stream, "%-14s %6s %6s %6s\r\n", "task", "size", "used", "free");
+    for(unsigned int i = 0; i < taskCount; i++)
+    {
+        const StackTask *task = &tasks[i];
+        if(task->base == NULL)
+        {
+            fprintf(stream, "%-14s %6u unknown\r\n", task->name, task->depth);
+            continue;
+        }
+        fprintf(stream, "%-14s %6u %6u %6u\r\n", task->name, task->depth,
+            task->depth - task->freeWords, task->freeWords);
+    }
+
+    fprintf(stream, "// Recommended stack sizes, in words\r\n");
+    for(unsigned int i = 0; i < taskCount; i++)
+    {
+        if(tasks[i].base != NULL)
+        {
+            fprintf(stream, "#define %s_STACK_SIZE %u\r\n", tasks[i].name,
+                recommendedSize(&tasks[i]));
+        }
+    }
+}
+
+void stackLcd(unsigned int index, char *top, char *bottom)
+{
+    if(index >= taskCount)
+    {
+        top[0] = '\0';
+        bottom[0] = '\0';
+        return;
+    }
+
+    const StackTask *task = &tasks[index];
+    snprintf(top, LCD_LINE_SIZE, "%-10.10s %5u", task->name, task->depth);
+    if(task->base == NULL)
+    {
+        snprintf(bottom, LCD_LINE_SIZE, "not painted");
+    }
+    else
+    {
+        snprintf(bottom, LCD_LINE_SIZE, "used %u free %u", task->depth - task->freeWords,
+            task->freeWords);
+    }
+}
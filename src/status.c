@@ -0,0 +1,99 @@
+/** @file status.c
+ * @brief Low priority reporting and the LED strip
+ *
+ * Requests are volatile flags that the caller sets and this task clears, so they need no lock.
+ * A request made twice before the task runs is only acted on once.
+ */
+
+#include "main.h"
+#include "arm.h"
+#include "led.h"
+#include "memory.h"
+#include "scheduler.h"
+#include "stack.h"
+#include "status.h"
+#include "timing.h"
+
+static volatile bool reportRequested = false;
+static volatile bool ledsOffRequested = false;
+
+static int ledTiming = -1;
+
+static TaskHandle statusTask = NULL;
+
+/**
+ * Handles requests and reports new scheduler overruns. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void statusRun(void *ignore)
+{
+    // Overruns at the last report, so only new overruns get reported
+    unsigned long reportedOverruns = schedulerTickOverruns();
+    // Whether the arm was learning its feedforward table at the last poll
+    bool armWasLearning = false;
+    unsigned int sinceOverruns = 0;
+
+    unsigned long wakeTime = millis();
+    while(true)
+    {
+        if(ledsOffRequested)
+        {
+            ledsOffRequested = false;
+            timingBegin(ledTiming);
+            ledFill(0, 0, 0);
+            ledShow();
+            timingEnd(ledTiming);
+        }
+
+        // The scheduler's stats are read while the control task may be updating them, which
+        // is good enough for a report
+        sinceOverruns += STATUS_POLL_PERIOD;
+        if(sinceOverruns >= STATUS_OVERRUN_PERIOD)
+        {
+            sinceOverruns = 0;
+            if(schedulerTickOverruns() != reportedOverruns)
+            {
+                reportedOverruns = schedulerTickOverruns();
+                schedulerPrintStats(stdout);
+            }
+        }
+
+        // Print the new feedforward table once the arm has learned it
+        if(armWasLearning && !armLearning())
+        {
+            armPrintFeedforward(stdout);
+        }
+        armWasLearning = armLearning();
+
+        if(reportRequested)
+        {
+            reportRequested = false;
+            timingPrint(stdout);
+            memoryPrint(stdout);
+            stackPrint(stdout);
+        }
+
+        taskDelayUntil(&wakeTime, STATUS_POLL_PERIOD);
+    }
+}
+
+void statusInit()
+{
+    if(statusTask == NULL)
+    {
+        ledTiming = timingRegister("led");
+        statusTask = stackTaskCreate("STATUS", statusRun, STATUS_STACK_SIZE, NULL,
+            STATUS_PRIORITY);
+    }
+}
+
+void statusRequestReport()
+{
+    reportRequested = true;
+}
+
+void statusRequestLedsOff()
+{
+    ledsOffRequested = true;
+}
@@ -0,0 +1,205 @@
+/** @file switches.c
+ * @brief Interrupt driven limit switches
+ *
+ * The pin change interrupts all run at the same priority, so they never interrupt each other,
+ * and switchesPoll() masks them while it works, so the switch state and the queue only ever
+ * have one writer at a time.
+ */
+
+#include "main.h"
+#include "interrupts.h"
+#include "motor.h"
+#include "switches.h"
+
+// Highest digital pin
+#define SWITCH_PINS 12
+
+/**
+ * A limit switch and the hard stop it guards
+ */
+typedef struct
+{
+    unsigned char pin;
+    // Motors stopped from going further while the switch is pressed, and the direction (the
+    // sign of the logical motor value) that they are stopped in
+    uint16_t ports;
+    int direction;
+} SwitchConfig;
+
+static const SwitchConfig switches[] =
+{
+    {TRAY_LIMIT_DOWN, TRAY_PORTS, -1},
+    {TRAY_LIMIT_UP, TRAY_PORTS, 1},
+};
+
+#define SWITCH_COUNT (sizeof(switches) / sizeof(switches[0]))
+
+/**
+ * Debounce state of one switch, only written by its interrupt and by switchesPoll() with
+ * interrupts masked after switchesInit()
+ */
+typedef struct
+{
+    const SwitchConfig *config;
+    volatile bool pressed;
+    uint32_t lastChange;
+    // An edge came too soon after lastChange, so the pin has to be read again once it settles
+    volatile bool unsettled;
+} SwitchState;
+
+// Indexed by pin - 1, config is NULL for pins without a switch
+static SwitchState states[SWITCH_PINS];
+
+static SwitchEvent queue[SWITCH_QUEUE_SIZE];
+// Events ever posted. Only advanced once the event is in the queue.
+static volatile uint32_t queueHead = 0;
+
+/**
+ * Adds an event to the queue, overwriting the oldest one. Only called from the interrupts.
+ */
+static void post(unsigned char pin, bool pressed, uint32_t time)
+{
+    uint32_t head = queueHead;
+    SwitchEvent *event = &queue[head % SWITCH_QUEUE_SIZE];
+    event->time = time;
+    event->pin = pin;
+    event->pressed = pressed;
+    __sync_synchronize();
+    queueHead = head + 1;
+}
+
+/**
+ * Takes a new level of a switch, engaging or releasing its hard stop
+ *
+ * @param pin The digital pin of the switch
+ * @param state The switch's state
+ * @param pressed The new level
+ * @param now micros() when the level was read
+ */
+static void change(unsigned char pin, SwitchState *state, bool pressed, uint32_t now)
+{
+    state->pressed = pressed;
+    state->lastChange = now;
+    motorOutSetHardStop(state->config->ports, state->config->direction, pressed);
+    post(pin, pressed, now);
+}
+
+/**
+ * The pin change interrupt of every switch
+ */
+static void switchChanged(unsigned char pin)
+{
+    uint32_t now = micros();
+    SwitchState *state = &states[pin - 1];
+    if(state->config == NULL)
+    {
+        return;
+    }
+
+    // An edge too soon after the last change is bounce, or a tap shorter than the debounce
+    // time. Either way the level it ends on is only known once the pin settles, which
+    // switchesPoll() reads.
+    if(now - state->lastChange < SWITCH_DEBOUNCE_TIME)
+    {
+        state->unsettled = true;
+        return;
+    }
+    state->unsettled = false;
+
+    bool pressed = !digitalRead(pin);
+    if(pressed != state->pressed)
+    {
+        change(pin, state, pressed, now);
+    }
+}
+
+void switchesInit()
+{
+    for(unsigned int i = 0; i < SWITCH_COUNT; i++)
+    {
+        const SwitchConfig *config = &switches[i];
+        SwitchState *state = &states[config->pin - 1];
+        if(state->config != NULL)
+        {
+            continue;
+        }
+
+        pinMode(config->pin, INPUT);
+        state->config = config;
+        state->pressed = !digitalRead(config->pin);
+        state->lastChange = micros() - SWITCH_DEBOUNCE_TIME;
+        state->unsettled = false;
+        motorOutSetHardStop(config->ports, config->direction, state->pressed);
+        ioSetInterrupt(config->pin, INTERRUPT_EDGE_BOTH, switchChanged);
+    }
+}
+
+void switchesPoll()
+{
+    for(unsigned int i = 0; i < SWITCH_COUNT; i++)
+    {
+        unsigned char pin = switches[i].pin;
+        SwitchState *state = &states[pin - 1];
+        if(!state->unsettled)
+        {
+            continue;
+        }
+
+        // Masked so the interrupt can't take an edge between the checks and the change
+        uint32_t primask = interruptsMask();
+        uint32_t now = micros();
+        if(state->unsettled && now - state->lastChange >= SWITCH_DEBOUNCE_TIME)
+        {
+            state->unsettled = false;
+            bool pressed = !digitalRead(pin);
+            if(pressed != state->pressed)
+            {
+                change(pin, state, pressed, now);
+            }
+        }
+        interruptsRestore(primask);
+    }
+}
+
+void switchesListen(SwitchListener *listener)
+{
+    listener->next = queueHead;
+}
+
+bool switchesNext(SwitchListener *listener, SwitchEvent *event)
+{
+    while(1)
+    {
+        uint32_t head = queueHead;
+        if(listener->next == head)
+        {
+            return false;
+        }
+        if(head - listener->next > SWITCH_QUEUE_SIZE)
+        {
+            listener->dropped += head - listener->next - SWITCH_QUEUE_SIZE;
+            listener->next = head - SWITCH_QUEUE_SIZE;
+        }
+
+        __sync_synchronize();
+        *event = queue[listener->next % SWITCH_QUEUE_SIZE];
+        __sync_synchronize();
+
+        // The slot gets reused once the queue has gone all the way around, which may have
+        // happened while copying it
+        if(queueHead - listener->next < SWITCH_QUEUE_SIZE)
+        {
+            listener->next++;
+            return true;
+        }
+    }
+}
+
+bool switchPressed(unsigned char pin)
+{
+    if(pin < 1 || pin > SWITCH_PINS)
+    {
+        return false;
+    }
+    return states[pin - 1].pressed;
+}
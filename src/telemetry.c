@@ -0,0 +1,116 @@
+/** @file telemetry.c
+ * @brief Binary telemetry log streamed over serial
+ *
+ * The ring buffer has a single producer (the task calling telemetrySample()) and a single
+ * consumer (the telemetry task). Each index is only written by one side and both are
+ * free-running counters, so the buffer needs no locks.
+ */
+
+#include "main.h"
+#include "arm.h"
+#include "memory.h"
+#include "stack.h"
+#include "telemetry.h"
+
+#define TELEMETRY_BUFFER_MASK (TELEMETRY_BUFFER_RECORDS - 1)
+
+// How often the telemetry task checks for new records, in ms
+#define TELEMETRY_DRAIN_PERIOD 10
+
+// Allocated from the arena by telemetryInit()
+static TelemetryRecord *buffer = NULL;
+// Next record to write (only changed by the producer) and next to send (only by the consumer)
+static volatile unsigned int head = 0;
+static volatile unsigned int tail = 0;
+
+static uint16_t sequence = 0;
+static volatile unsigned long dropped = 0;
+
+static PROS_FILE *telemetryStream = NULL;
+static TaskHandle telemetryTask = NULL;
+
+/**
+ * Sends queued records to the stream. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void telemetryDrain(void *ignore)
+{
+    while(1)
+    {
+        while(tail != head)
+        {
+            fwrite(&buffer[tail & TELEMETRY_BUFFER_MASK], sizeof(TelemetryRecord), 1,
+                telemetryStream);
+
+            // Make sure the record has been read before the producer is allowed to reuse it
+            __sync_synchronize();
+            tail++;
+        }
+
+        taskDelay(TELEMETRY_DRAIN_PERIOD);
+    }
+}
+
+void telemetryInit(PROS_FILE *stream)
+{
+    telemetryStream = stream;
+    if(telemetryTask == NULL)
+    {
+        buffer = memoryAlloc(sizeof(TelemetryRecord) * TELEMETRY_BUFFER_RECORDS, "telemetry");
+        if(buffer == NULL)
+        {
+            return;
+        }
+
+        telemetryTask = stackTaskCreate("TELEMETRY", telemetryDrain, TELEMETRY_STACK_SIZE, NULL,
+            TELEMETRY_TASK_PRIORITY);
+    }
+}
+
+void telemetrySample()
+{
+    uint16_t recordSequence = sequence++;
+
+    if(buffer == NULL || head - tail >= TELEMETRY_BUFFER_RECORDS)
+    {
+        dropped++;
+        return;
+    }
+
+    TelemetryRecord *record = &buffer[head & TELEMETRY_BUFFER_MASK];
+    record->sync[0] = TELEMETRY_SYNC_0;
+    record->sync[1] = TELEMETRY_SYNC_1;
+    record->sequence = recordSequence;
+    record->timestamp = micros();
+    record->armTarget = armGetTarget();
+    record->armPosition = armGetPosition();
+    for(unsigned char port = 1; port <= MOTOR_PORTS; port++)
+    {
+        record->motors[port - 1] = motorOutGet(port);
+        int heat = q16MulInt(motorOutHeat(port), 100);
+        record->heat[port - 1] = heat > UINT8_MAX ? UINT8_MAX : heat;
+    }
+    record->battery = powerLevelMain();
+    record->stackFree = stackLowestFree();
+    size_t heapFree = memoryHeapFree();
+    record->heapFree = heapFree > UINT16_MAX ? UINT16_MAX : heapFree;
+    record->dropped = dropped;
+
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint8_t checksum = 0;
+    for(unsigned int i = 0; i < sizeof(TelemetryRecord) - 1; i++)
+    {
+        checksum += bytes[i];
+    }
+    record->checksum = checksum;
+
+    // Publish the record only once it has been completely written
+    __sync_synchronize();
+    head++;
+}
+
+unsigned long telemetryDropped()
+{
+    return dropped;
+}
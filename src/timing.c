@@ -0,0 +1,190 @@
+/** @file timing.c
+ * @brief Loop timing instrumentation
+ */
+
+#include "main.h"
+#include "timing.h"
+
+#define DEMCR (*(volatile uint32_t *)0xE000EDFC)
+#define DEMCR_TRCENA (1 << 24)
+#define DWT_CTRL (*(volatile uint32_t *)0xE0001000)
+#define DWT_CTRL_CYCCNTENA (1 << 0)
+
+static TimingStats sections[TIMING_MAX_SECTIONS];
+static int sectionCount = 0;
+
+/**
+ * @return true if two strings are the same (the kernel library has no strcmp())
+ */
+static bool sameName(const char *a, const char *b)
+{
+    while(*a != '\0' && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+/**
+ * Clears the statistics of one section
+ */
+static void clearStats(TimingStats *stats)
+{
+    stats->count = 0;
+    stats->min = UINT32_MAX;
+    stats->max = 0;
+    stats->total = 0;
+    for(unsigned int i = 0; i < TIMING_BUCKETS; i++)
+    {
+        stats->histogram[i] = 0;
+    }
+}
+
+/**
+ * @param micros A measured time
+ * @return The histogram bucket for the time
+ */
+static unsigned int bucketFor(uint32_t micros)
+{
+    if(micros < TIMING_BUCKET_BASE)
+    {
+        return 0;
+    }
+
+    // Number of doublings of the base, found with a single CLZ instruction
+    unsigned int bucket = 32 - __builtin_clz(micros / TIMING_BUCKET_BASE);
+    return bucket < TIMING_BUCKETS ? bucket : TIMING_BUCKETS - 1;
+}
+
+void timingInit()
+{
+#if TIMING_USE_DWT
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+int timingRegister(const char *name)
+{
+    for(int i = 0; i < sectionCount; i++)
+    {
+        if(sameName(sections[i].name, name))
+        {
+            return i;
+        }
+    }
+
+    if(sectionCount >= TIMING_MAX_SECTIONS)
+    {
+        return -1;
+    }
+
+    sections[sectionCount].name = name;
+    clearStats(&sections[sectionCount]);
+    return sectionCount++;
+}
+
+void timingRecord(int section, uint32_t micros)
+{
+    if(section < 0 || section >= sectionCount)
+    {
+        return;
+    }
+
+    TimingStats *stats = &sections[section];
+    stats->count++;
+    stats->total += micros;
+    if(micros < stats->min)
+    {
+        stats->min = micros;
+    }
+    if(micros > stats->max)
+    {
+        stats->max = micros;
+    }
+    stats->histogram[bucketFor(micros)]++;
+}
+
+void timingBegin(int section)
+{
+    if(section >= 0 && section < sectionCount)
+    {
+        sections[section].start = timingNow();
+    }
+}
+
+uint32_t timingEnd(int section)
+{
+    if(section < 0 || section >= sectionCount)
+    {
+        return 0;
+    }
+
+    uint32_t elapsed = timingToMicros(timingNow() - sections[section].start);
+    timingRecord(section, elapsed);
+    return elapsed;
+}
+
+const TimingStats *timingGet(int section)
+{
+    if(section < 0 || section >= sectionCount)
+    {
+        return NULL;
+    }
+    return &sections[section];
+}
+
+int timingCount()
+{
+    return sectionCount;
+}
+
+void timingReset()
+{
+    for(int i = 0; i < sectionCount; i++)
+    {
+        clearStats(&sections[i]);
+    }
+}
+
+void timingPrint(PROS_FILE *stream)
+{
+    fprintf(stream, "%-10s %8s %6s %6s %6s  histogram (<%dus, then doubling)\r\n", "section",
+        "count", "min", "avg", "max", TIMING_BUCKET_BASE);
+
+    for(int i = 0; i < sectionCount; i++)
+    {
+        const TimingStats *stats = &sections[i];
+        if(stats->count == 0)
+        {
+            fprintf(stream, "%-10s %8d\r\n", stats->name, 0);
+            continue;
+        }
+
+        fprintf(stream, "%-10s %8lu %6lu %6lu %6lu ", stats->name, (unsigned long)stats->count,
+            (unsigned long)stats->min, (unsigned long)(stats->total / stats->count),
+            (unsigned long)stats->max);
+        for(unsigned int bucket = 0; bucket < TIMING_BUCKETS; bucket++)
+        {
+            fprintf(stream, " %lu", (unsigned long)stats->histogram[bucket]);
+        }
+        fprintf(stream, "\r\n");
+    }
+}
+
+void timingLcd(int section, char *top, char *bottom)
+{
+    const TimingStats *stats = timingGet(section);
+    if(stats == NULL)
+    {
+        top[0] = '\0';
+        bottom[0] = '\0';
+        return;
+    }
+
+    unsigned long average = stats->count ? (unsigned long)(stats->total / stats->count) : 0;
+    snprintf(top, LCD_LINE_SIZE, "%-8s n%lu", stats->name, (unsigned long)stats->count);
+    snprintf(bottom, LCD_LINE_SIZE, "%lu/%lu/%luus", stats->count ? (unsigned long)stats->min : 0,
+        average, (unsigned long)stats->max);
+}
@@ -0,0 +1,219 @@
+/** @file tray.c
+ * @brief Profiled position control for the tray
+ *
+ * The profile is worked out on the fly every period instead of ahead of time, so the target can
+ * change in the middle of a move. The speed is the fastest that can still stop at the target
+ * (and slow down to TRAY_SLOW_SPEED by the start of the slow zone), capped at the cruise speed
+ * and changed by at most TRAY_ACCELERATION per second.
+ */
+
+#include "main.h"
+#include "config.h"
+#include "motor.h"
+#include "sensors.h"
+#include "stack.h"
+#include "switches.h"
+#include "tray.h"
+
+// Change of profile speed allowed per period
+#define TRAY_SPEED_STEP (TRAY_ACCELERATION * TRAY_PERIOD / 1000)
+
+// Aligned 32 bit reads and writes are atomic on the Cortex-M3, so these are shared without a
+// mutex. The target is set by other tasks, and by the tray task when a move gets cut short.
+static volatile int trayTarget = TRAY_LOWER_BOUND;
+static volatile int trayPosition = 0;
+static volatile bool atTarget = true;
+static volatile bool holdRequested = false;
+
+static TaskHandle trayTask = NULL;
+
+/**
+ * @return The integer square root of a value, rounded down
+ */
+static uint32_t squareRoot(uint32_t value)
+{
+    uint32_t root = 0;
+    for(uint32_t bit = 1u << 30; bit != 0; bit >>= 2)
+    {
+        if(value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+/**
+ * @param distance How far the profile is from the target, in potentiometer units
+ * @param raising Whether the move is upwards, which ends in the slow zone
+ * @return The fastest speed the profile may have this far from the target
+ */
+static int speedLimit(int distance, bool raising)
+{
+    uint32_t limit = squareRoot(2u * TRAY_ACCELERATION * (uint32_t)distance);
+    if(raising)
+    {
+        uint32_t slow = TRAY_SLOW_SPEED;
+        if(distance > TRAY_SLOW_ZONE)
+        {
+            // Slow enough to be down to the slow speed when the zone starts
+            slow = squareRoot(slow * slow + 2u * TRAY_ACCELERATION * (distance - TRAY_SLOW_ZONE));
+        }
+        limit = limit < slow ? limit : slow;
+    }
+    return limit < TRAY_FAST_SPEED ? (int)limit : TRAY_FAST_SPEED;
+}
+
+/**
+ * The tray control loop. Never returns.
+ *
+ * @param ignore Unused
+ */
+static void trayControl(void *ignore)
+{
+    // The profile's position and speed
+    q16_t setpoint = 0;
+    int speed = 0;
+
+    SwitchListener switches;
+    switchesListen(&switches);
+
+    bool wasEnabled = false;
+    unsigned long wakeTime = millis();
+
+    while(1)
+    {
+        SensorReading reading;
+        sensorGet(TRAY_POTENTIOMETER, &reading);
+
+        // Like the arm, forget what the kernel may have changed while disabled
+        bool enabled = isEnabled();
+        if(enabled && !wasEnabled)
+        {
+            motorOutInvalidate(TRAY_PORTS);
+        }
+        wasEnabled = enabled;
+
+        // Hitting either end stops the move there
+        switchesPoll();
+        SwitchEvent event;
+        while(switchesNext(&switches, &event))
+        {
+            if(event.pressed && ((event.pin == TRAY_LIMIT_UP && speed > 0) ||
+                (event.pin == TRAY_LIMIT_DOWN && speed < 0)))
+            {
+                setpoint = reading.value;
+                speed = 0;
+                trayTarget = q16ToInt(reading.value);
+            }
+        }
+
+        if(holdRequested)
+        {
+            // Stop where the current speed can be brought down to 0, without going past either
+            // end like traySetTarget()
+            int stopping = speed * speed / (2 * TRAY_ACCELERATION);
+            trayTarget = clampInt(q16ToInt(setpoint) + (speed > 0 ? stopping : -stopping),
+                TRAY_LOWER_BOUND, TRAY_UPPER_BOUND);
+            holdRequested = false;
+        }
+
+        int output = 0;
+        if(enabled)
+        {
+            q16_t target = q16FromInt(trayTarget);
+            q16_t remaining = target - setpoint;
+            int distance = q16ToInt(remaining > 0 ? remaining : -remaining);
+            int limit = speedLimit(distance, remaining > 0);
+            int desired = remaining > 0 ? limit : -limit;
+            speed = clampInt(desired, speed - TRAY_SPEED_STEP, speed + TRAY_SPEED_STEP);
+
+            // Finish the move instead of stepping past the target
+            q16_t step = q16FromInt(speed) / (1000 / TRAY_PERIOD);
+            if((remaining >= 0 && step >= remaining) || (remaining <= 0 && step <= remaining))
+            {
+                setpoint = target;
+                speed = 0;
+            }
+            else
+            {
+                setpoint += step;
+            }
+
+            q16_t error = setpoint - reading.value;
+            q16_t feedforward = q16Mul(q16FromInt(speed), TRAY_KV);
+            q16_t proportional = q16Mul(error, config.trayKp);
+            q16_t derivative = q16Mul(q16FromInt(speed) - reading.velocity, TRAY_KD);
+            output = clampInt(q16ToInt(feedforward + proportional + derivative), -127, 127);
+
+            bool close = error > -q16FromInt(TRAY_TOLERANCE) && error < q16FromInt(TRAY_TOLERANCE);
+            atTarget = setpoint == target && close;
+
+            // Resting on the bottom needs no power
+            if(atTarget && trayTarget <= TRAY_LOWER_BOUND)
+            {
+                output = 0;
+            }
+        }
+        else
+        {
+            // The kernel has the motors off while disabled, so hold wherever the tray ends up
+            setpoint = reading.value;
+            speed = 0;
+            trayTarget = q16ToInt(reading.value);
+            atTarget = true;
+        }
+
+        trayPosition = q16ToInt(reading.value);
+
+        motorOutRequest(TRAY, output, MOTOR_PRIORITY_DRIVER);
+        motorOutSetSpeed(TRAY_PORTS, reading.velocity / TRAY_FREE_SPEED);
+        motorOutFlush(TRAY_PORTS);
+
+        taskDelayUntil(&wakeTime, TRAY_PERIOD);
+    }
+}
+
+void trayInit()
+{
+    if(trayTask == NULL)
+    {
+        trayTask = stackTaskCreate("TRAY", trayControl, TRAY_STACK_SIZE, NULL,
+            TRAY_TASK_PRIORITY);
+    }
+}
+
+void traySetTarget(int target)
+{
+    target = clampInt(target, TRAY_LOWER_BOUND, TRAY_UPPER_BOUND);
+    if(target != trayTarget)
+    {
+        atTarget = false;
+        trayTarget = target;
+    }
+}
+
+void trayHold()
+{
+    holdRequested = true;
+}
+
+int trayGetTarget()
+{
+    return trayTarget;
+}
+
+int trayGetPosition()
+{
+    return trayPosition;
+}
+
+bool trayAtTarget()
+{
+    return atTarget && !holdRequested;
+}
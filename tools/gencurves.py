@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Generates src/curves.c, the joystick response curve lookup tables.
+
+Each curve maps a raw joystick value (-127 to 127) to a motor power with the scale, expo and
+deadband baked in, so the robot shapes its inputs with a single table lookup per axis. Tables
+are indexed by the joystick value cast to uint8_t (see curves.h).
+
+Tune the curves in CURVES below; the Makefile regenerates src/curves.c when this file changes.
+
+Usage: gencurves.py [output file]
+"""
+
+import sys
+
+# name: (scale, expo, deadband)
+#   scale    multiplies the output, e.g. 1 / 1.4 makes turning less sensitive
+#   expo     0 is linear, 1 is fully cubic (finer control near the center of the stick)
+#   deadband outputs smaller than this become 0 to avoid controller drift
+CURVES = {
+    "forwardCurve": (1.0, 0.0, 15),
+    "turnCurve": (1 / 1.4, 0.0, 15),
+}
+
+
+def shape(value, scale, expo, deadband):
+    """Applies a curve to one joystick value."""
+    value = max(-127, min(127, value))
+    normalized = value / 127.0
+    shaped = (1 - expo) * normalized + expo * normalized ** 3
+    output = int(round(shaped * scale * 127))
+    if abs(output) < deadband:
+        return 0
+    return max(-127, min(127, output))
+
+
+def table(scale, expo, deadband):
+    """Builds the 256 entry table, indexed by the joystick value as an unsigned byte."""
+    entries = []
+    for index in range(256):
+        value = index - 256 if index >= 128 else index
+        entries.append(shape(value, scale, expo, deadband))
+    return entries
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else "src/curves.c"
+
+    lines = [
+        "/** @file curves.c",
+        " * @brief Joystick response curve lookup tables",
+        " *",
+        " * Generated by tools/gencurves.py, do not edit by hand.",
+        " */",
+        "",
+        '#include "main.h"',
+        '#include "curves.h"',
+    ]
+    for name, (scale, expo, deadband) in CURVES.items():
+        entries = table(scale, expo, deadband)
+        lines.append("")
+        lines.append("// scale %.4f, expo %.2f, deadband %d" % (scale, expo, deadband))
+        lines.append("const int8_t %s[256] =" % name)
+        lines.append("{")
+        for row in range(0, 256, 16):
+            values = ", ".join("%4d" % entry for entry in entries[row:row + 16])
+            lines.append("    %s,  // %d" % (values, row - 256 if row >= 128 else row))
+        lines.append("};")
+
+    with open(path, "w", newline="\r\n") as output:
+        output.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""Generates src/paths.c, the autonomous paths and their motion profiles.
+
+Each path is a starting pose and a list of waypoints. The robot drives from one waypoint to the
+next by turning in place to face it and then driving straight to it, and every turn and drive
+gets a velocity profile sampled at the follower's period (see path.h). Planning the profiles
+here keeps all of the math (and the floating point) off the robot.
+
+Profiles are trapezoidal, or S-curves when a jerk limit is given. The S-curve is the trapezoid
+run through a moving average as long as the time it takes to reach full acceleration, which
+limits the jerk without changing the distance travelled.
+
+Tune the paths in PATHS below; the Makefile regenerates src/paths.c when this file changes.
+
+Usage: genpaths.py [output file]
+"""
+
+import math
+import sys
+
+# Follower period in seconds, must match PATH_PERIOD in path.h
+PERIOD = 0.01
+
+# Drive limits: max velocity in inches/s, max acceleration in inches/s^2 and max jerk in
+# inches/s^3 (None for a plain trapezoid). Keep them under what the drive can do, so the
+# follower has power left over for feedback: the velocity under DRIVE_MAX_SPEED in drive.h
+# (18 of the 21 inches/s free speed) and the acceleration under what DRIVE_ACCEL's ramp in
+# main.h gets to.
+DRIVE_LIMITS = (15.0, 36.0, 300.0)
+# Turn limits: the same in degrees. Turning in place at 120 degrees/s has the wheels of the
+# 14" track (ODOMETRY_TRACK_WIDTH) at about 15 inches/s.
+TURN_LIMITS = (120.0, 300.0, 2000.0)
+
+# Turns smaller than this (in degrees) are skipped
+MIN_TURN = 1.0
+
+# name: (start, waypoints)
+#   start     (x, y, heading) of the robot when the path starts, in inches and degrees
+#   waypoints (x, y) to drive to, or (x, y, True) to back up to it
+PATHS = {
+    # Drives up the row of four cubes in front of the small goal, then backs out and turns to
+    # face the goal zone
+    "rowPath": ((0.0, 0.0, 0.0), [
+        (40.0, 0.0),
+        (16.0, 0.0, True),
+        (6.0, -14.0),
+    ]),
+}
+
+
+def trapezoid(distance, limits):
+    """Samples a profile covering distance (which may be negative) every PERIOD.
+
+    Returns a list of (position, velocity, acceleration) tuples.
+    """
+    max_velocity, max_accel, max_jerk = limits
+    direction = -1.0 if distance < 0 else 1.0
+    distance = abs(distance)
+
+    # Triangle profile if there isn't room to reach full speed
+    velocity = min(max_velocity, math.sqrt(distance * max_accel))
+    accel_time = velocity / max_accel
+    cruise_time = (distance - velocity * accel_time) / velocity if velocity > 0 else 0.0
+    total_time = 2 * accel_time + cruise_time
+
+    velocities = []
+    steps = int(math.ceil(total_time / PERIOD))
+    for step in range(1, steps + 1):
+        t = min(step * PERIOD, total_time)
+        if t < accel_time:
+            velocities.append(max_accel * t)
+        elif t < accel_time + cruise_time:
+            velocities.append(velocity)
+        else:
+            velocities.append(max(0.0, max_accel * (total_time - t)))
+
+    if max_jerk is not None:
+        window = max(1, int(round(max_accel / max_jerk / PERIOD)))
+        padded = velocities + [0.0] * (window - 1)
+        velocities = []
+        for i in range(len(padded)):
+            samples = padded[max(0, i - window + 1):i + 1]
+            velocities.append(sum(samples) / window)
+
+    # Integrate, then scale so the profile ends exactly at the target despite sampling error
+    points = []
+    position = 0.0
+    previous = 0.0
+    for velocity in velocities:
+        position += (previous + velocity) / 2 * PERIOD
+        points.append([position, velocity, (velocity - previous) / PERIOD])
+        previous = velocity
+    if position > 0:
+        for point in points:
+            point[0] *= distance / position
+    points.append([distance, 0.0, 0.0])
+
+    return [(direction * p, direction * v, direction * a) for p, v, a in points]
+
+
+def legs(start, waypoints):
+    """Splits a path into turn and drive legs.
+
+    Returns a list of (type, x, y, heading, profile) tuples, where x and y are where the leg
+    starts and heading is the heading at the start of a turn or during a drive.
+    """
+    x, y, heading = start
+    result = []
+    for waypoint in waypoints:
+        target_x, target_y = waypoint[0], waypoint[1]
+        reverse = len(waypoint) > 2 and waypoint[2]
+        dx = target_x - x
+        dy = target_y - y
+        distance = math.hypot(dx, dy)
+        if distance == 0:
+            continue
+
+        bearing = math.degrees(math.atan2(dy, dx))
+        if reverse:
+            bearing += 180
+            distance = -distance
+        # Headings are cumulative, so take the shortest way round to the new one
+        turn = (bearing - heading + 180) % 360 - 180
+        if abs(turn) >= MIN_TURN:
+            result.append(("PATH_LEG_TURN", x, y, heading, trapezoid(turn, TURN_LIMITS)))
+            heading += turn
+
+        result.append(("PATH_LEG_DRIVE", x, y, heading, trapezoid(distance, DRIVE_LIMITS)))
+        x, y = target_x, target_y
+    return result
+
+
+def q16(value):
+    return int(round(value * 65536))
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else "src/paths.c"
+
+    lines = [
+        "/** @file paths.c",
+        " * @brief Autonomous paths and motion profiles",
+        " *",
+        " * Generated by tools/genpaths.py, do not edit by hand.",
+        " */",
+        "",
+        '#include "main.h"',
+        '#include "path.h"',
+    ]
+    for name, (start, waypoints) in PATHS.items():
+        path_legs = legs(start, waypoints)
+        for index, (kind, x, y, heading, profile) in enumerate(path_legs):
+            lines.append("")
+            lines.append("// %s leg %d: %s from (%.1f, %.1f) at %.1f degrees, %.2fs" % (
+                name, index, "turn" if kind == "PATH_LEG_TURN" else "drive", x, y, heading,
+                len(profile) * PERIOD))
+            lines.append("static const ProfilePoint %sLeg%d[%d] =" % (name, index, len(profile)))
+            lines.append("{")
+            for position, velocity, acceleration in profile:
+                lines.append("    {%d, %d, %d}," % (q16(position), q16(velocity),
+                                                   q16(acceleration)))
+            lines.append("};")
+
+        lines.append("")
+        lines.append("static const PathLeg %sLegs[%d] =" % (name, len(path_legs)))
+        lines.append("{")
+        for index, (kind, x, y, heading, profile) in enumerate(path_legs):
+            lines.append("    {%s, %d, %d, %d, %sLeg%d, %d}," % (
+                kind, q16(x), q16(y), q16(heading), name, index, len(profile)))
+        lines.append("};")
+
+        lines.append("")
+        lines.append("const Path %s =" % name)
+        lines.append("{")
+        lines.append('    "%s",' % name)
+        lines.append("    {%d, %d, %d}," % (q16(start[0]), q16(start[1]), q16(start[2])))
+        lines.append("    %sLegs," % name)
+        lines.append("    %d" % len(path_legs))
+        lines.append("};")
+
+    lines.append("")
+    lines.append("const Path *const autonPaths[] =")
+    lines.append("{")
+    for name in PATHS:
+        lines.append("    &%s," % name)
+    lines.append("};")
+    lines.append("")
+    lines.append("const unsigned int autonPathCount = %d;" % len(PATHS))
+
+    with open(path, "w", newline="\r\n") as output:
+        output.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Reports where the firmware's flash and RAM go, and fails if either is over budget.
+
+Reads the linker map for the totals and for how much each object file or library archive
+contributes, and the ELF's symbol table (through nm) for the largest symbols. Flash is
+everything loaded into it: the vector table, code, constants and the initial values of .data.
+RAM is the static data (.data and .bss); whatever is left over is the heap, which the task
+stacks, semaphores and files come from.
+
+The Makefile runs this for "make sizereport" and "make size" (see the size profile there).
+
+Usage:
+    sizereport.py output.elf output.map [--nm arm-none-eabi-nm] [--flash-budget BYTES]
+                  [--ram-budget BYTES] [--top 30]
+"""
+
+import argparse
+import collections
+import os
+import re
+import subprocess
+import sys
+
+# Output sections loaded into flash and the ones taking up RAM (.data is in both)
+FLASH_SECTIONS = (".isr_vector", ".text", ".data")
+RAM_SECTIONS = (".data", ".bss")
+
+# nm symbol types placed in flash and in RAM
+FLASH_TYPES = "TtRr"
+RAM_TYPES = "DdBbCc"
+
+# An output section, or an input section with its address and size on the same line or the next
+OUTPUT_SECTION = re.compile(r"^(\.\S+)\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)")
+INPUT_SECTION = re.compile(r"^ (\S+)(?:\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)\s+(\S.*))?$")
+WRAPPED_SECTION = re.compile(r"^\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def origin(path):
+    """Groups an input file by its library archive, or by its own name for object files."""
+    archive = re.match(r"(.*\.a)\(.*\)$", path)
+    if archive:
+        return os.path.basename(archive.group(1))
+    return os.path.basename(path)
+
+
+def parse_map(lines):
+    """Reads the output section sizes and the bytes each input file puts in them."""
+    sections = {}
+    origins = collections.defaultdict(lambda: collections.Counter())
+    output = None
+    pending = None
+    in_map = False
+    for line in lines:
+        line = line.rstrip("\r\n")
+        if not in_map:
+            # The discarded sections come first, skip them
+            in_map = line.startswith("Linker script and memory map")
+            continue
+
+        match = OUTPUT_SECTION.match(line)
+        if match:
+            output = match.group(1)
+            sections[output] = int(match.group(2), 16)
+            pending = None
+            continue
+        if line.startswith(".") or line.startswith("/DISCARD/"):
+            # Output section whose address is on the next line, or one that isn't loaded
+            output = line.split()[0]
+            pending = None
+            continue
+
+        if pending:
+            # Input section name was too long, its address and size wrapped onto this line
+            pending = None
+            match = WRAPPED_SECTION.match(line)
+            if match:
+                if output in sections:
+                    origins[output][origin(match.group(2))] += int(match.group(1), 16)
+                continue
+
+        match = INPUT_SECTION.match(line)
+        if match and output in sections:
+            if match.group(2):
+                if match.group(1) != "*fill*":
+                    origins[output][origin(match.group(3))] += int(match.group(2), 16)
+            elif match.group(1).startswith(".") or match.group(1) == "COMMON":
+                pending = match.group(1)
+    return sections, origins
+
+
+def parse_symbols(nm, elf):
+    """Lists (size, type, name) of every sized symbol, largest first."""
+    result = subprocess.run([nm, "-S", "-t", "d", "--size-sort", elf],
+                            stdout=subprocess.PIPE, universal_newlines=True, check=True)
+    symbols = []
+    for line in result.stdout.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) == 4:
+            symbols.append((int(fields[1]), fields[2], fields[3]))
+    symbols.sort(reverse=True)
+    return symbols
+
+
+def usage(name, used, budget):
+    """Formats one line of the totals, with how much of the budget it uses."""
+    if not budget:
+        return "%-6s %8d bytes" % (name, used)
+    return "%-6s %8d of %8d bytes (%5.1f%%)" % (name, used, budget, 100.0 * used / budget)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf")
+    parser.add_argument("map")
+    parser.add_argument("--nm", default="arm-none-eabi-nm")
+    parser.add_argument("--flash-budget", type=int, default=0, help="0 for no budget")
+    parser.add_argument("--ram-budget", type=int, default=0, help="0 for no budget")
+    parser.add_argument("--top", type=int, default=30, help="number of symbols to list")
+    args = parser.parse_args()
+
+    with open(args.map) as stream:
+        sections, origins = parse_map(stream)
+    symbols = parse_symbols(args.nm, args.elf)
+
+    flash = sum(sections.get(name, 0) for name in FLASH_SECTIONS)
+    ram = sum(sections.get(name, 0) for name in RAM_SECTIONS)
+
+    for title, names in (("Flash", FLASH_SECTIONS), ("RAM", RAM_SECTIONS)):
+        total = collections.Counter()
+        for name in names:
+            total.update(origins[name])
+        print("%s by file:" % title)
+        for name, size in total.most_common():
+            if size:
+                print("  %8d  %s" % (size, name))
+
+    print("Largest symbols:")
+    for size, kind, name in symbols[:args.top]:
+        where = "flash" if kind in FLASH_TYPES else "RAM" if kind in RAM_TYPES else "?"
+        print("  %8d  %-5s %s" % (size, where, name))
+
+    print(usage("Flash", flash, args.flash_budget))
+    print(usage("RAM", ram, args.ram_budget))
+
+    over = []
+    if args.flash_budget and flash > args.flash_budget:
+        over.append("flash by %d bytes" % (flash - args.flash_budget))
+    if args.ram_budget and ram > args.ram_budget:
+        over.append("RAM by %d bytes" % (ram - args.ram_budget))
+    if over:
+        print("Over budget: " + ", ".join(over), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
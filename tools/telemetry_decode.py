@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Decodes the binary telemetry stream from the robot (see include/telemetry.h) into CSV.
+
+Reads from a file captured from the serial port, or straight from the port if pyserial is
+installed. Anything that isn't a valid record (such as text printed to the same stream) is
+skipped.
+
+Usage:
+    telemetry_decode.py capture.bin > log.csv
+    telemetry_decode.py /dev/ttyACM0 --serial [--baud 115200] > log.csv
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+MOTOR_PORTS = 10
+
+# Must match TelemetryRecord
+RECORD = struct.Struct("<2sHIhh%db%dBHHHHB" % (MOTOR_PORTS, MOTOR_PORTS))
+
+HEADER = (["sequence", "time_us", "arm_target", "arm_position"] +
+          ["motor%d" % port for port in range(1, MOTOR_PORTS + 1)] +
+          ["heat%d" % port for port in range(1, MOTOR_PORTS + 1)] +
+          ["battery_mv", "stack_free_words", "heap_free_bytes", "dropped"])
+
+
+def records(stream):
+    """Yields the fields of every valid record in a byte stream."""
+    data = b""
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            return
+        data += chunk
+
+        while True:
+            start = data.find(SYNC)
+            if start < 0:
+                # Keep a trailing byte in case it is the first half of a sync marker
+                data = data[-1:]
+                break
+            if len(data) - start < RECORD.size:
+                data = data[start:]
+                break
+
+            raw = data[start:start + RECORD.size]
+            if sum(raw[:-1]) & 0xFF != raw[-1]:
+                # Not a real record, look for the next sync marker
+                data = data[start + 1:]
+                continue
+
+            data = data[start + RECORD.size:]
+            yield RECORD.unpack(raw)[1:-1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="capture file or serial port")
+    parser.add_argument("--serial", action="store_true", help="read from a serial port")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    if args.serial:
+        import serial
+        stream = serial.Serial(args.source, args.baud, timeout=None)
+    else:
+        stream = open(args.source, "rb")
+
+    print(",".join(HEADER))
+    last_sequence = None
+    for fields in records(stream):
+        sequence = fields[0]
+        if last_sequence is not None and (sequence - last_sequence) & 0xFFFF != 1:
+            print("# gap before sequence %d" % sequence, file=sys.stderr)
+        last_sequence = sequence
+        print(",".join(str(field) for field in fields))
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()